@@ -1,43 +1,82 @@
 #include "ArgsManager.h"
 
-Content ArgsManager::getContent(const Argument& arg,
-	const unsigned int argc, const unsigned int idx, const char* const argv[]) const
+bool ArgsManager::checkExists(const Argument& argument) const
 {
-	const char* const nextParam = argv[idx + 1];
+	if (registeredNames.count(argument.getArg1()) != 0)
+		return true;
 
-	// Extract content
-	if ((idx == (argc - 1)) || nextParam == nullptr || nextParam[0] == '-' || nextParam[0] == '\0') {
-		const auto& p2 = arg.getArg2();
-		std::string exceptionMessage;
+	const auto& arg2 = argument.getArg2();
+	return !arg2.empty() && registeredNames.count(arg2) != 0;
+}
+
+ArgsManager& ArgsManager::add(const Argument& arg, std::uint8_t flags, ArgId* id)
+{
+	if (checkExists(arg))
+		throw std::runtime_error("This argument has already been added");
 
-		exceptionMessage
-			.append("Argument '")
-			.append(arg.getArg1() + ((!p2.empty()) ? "' / '" + p2 + "'" : "'"))
-			.append(" not found!");
+	const auto newId = static_cast<ArgId>(arguments.size());
+	arguments.push_back(arg);
+	argumentFlags.push_back(flags);
 
-		throw InvalidArg(exceptionMessage);
-	}
-	return nextParam;
+	registeredNames.emplace(arg.getArg1(), newId);
+	if (!arg.getArg2().empty())
+		registeredNames.emplace(arg.getArg2(), newId);
+
+	plan.reset();
+	lazyResult.reset();
+
+	if (id != nullptr)
+		*id = newId;
+	return *this;
 }
 
-bool ArgsManager::checkExists(const Argument& argument)
-{
-	for (const auto& arg : requiredArgs) {
-		if (argument == arg)
-			return true;
-	}
+ArgsManager::ArgsManager() :
+	ArgsManager(std::pmr::get_default_resource()) {}
 
-	for (const auto& arg : requiredArgSet) {
-		if (argument == arg)
-			return true;
-	}
+ArgsManager::ArgsManager(std::pmr::memory_resource* resource) :
+	resource(resource), arguments(resource), argumentFlags(resource), registeredNames(resource),
+	result(resource), configFiles(resource), lazyResult(resource), helpArgs(resource) {}
 
-	for (const auto& arg : optionalArgs) {
-		if (argument == arg)
-			return true;
-	}
+ArgsManager::ArgsManager(ArgsManager&& other) :
+	resource(other.resource), arguments(std::move(other.arguments)), argumentFlags(std::move(other.argumentFlags)),
+	registeredNames(std::move(other.registeredNames)), plan(std::move(other.plan)), nameTable(other.nameTable),
+	result(std::move(other.result)), options(other.options), configFiles(std::move(other.configFiles)),
+	lazyResult(std::move(other.lazyResult)), lazy(other.lazy), helpArgs(std::move(other.helpArgs))
+{
+	// The files are owned by this instance now, other must not view them
+	options.configFiles = configFiles.data();
+	other.options.configFiles = nullptr;
+	other.options.configCount = 0;
+}
 
-	return false;
+ArgsManager& ArgsManager::operator=(ArgsManager&& other)
+{
+	if (this == &other)
+		return *this;
+
+	// The lazy result points into the arguments, which are copied if the resources differ
+	const bool sameResource = resource == other.resource;
+
+	arguments = std::move(other.arguments);
+	argumentFlags = std::move(other.argumentFlags);
+	registeredNames = std::move(other.registeredNames);
+	// The plan of other was built with its resource, it is built again with the resource of this instance
+	plan = sameResource ? std::move(other.plan) : nullptr;
+	other.plan.reset();
+	nameTable = other.nameTable;
+	result = std::move(other.result);
+	options = other.options;
+	configFiles = std::move(other.configFiles);
+	options.configFiles = configFiles.data();
+	other.options.configFiles = nullptr;
+	other.options.configCount = 0;
+	lazyResult = std::move(other.lazyResult);
+	lazy = other.lazy;
+	helpArgs = std::move(other.helpArgs);
+
+	if (!sameResource)
+		lazyResult.reset();
+	return *this;
 }
 
 ArgsManager& ArgsManager::getInstance()
@@ -58,194 +97,294 @@ ArgsManager& ArgsManager::addHelp(const std::string& helpParam)
 
 ArgsManager& ArgsManager::addRequired(const Argument& requredArg)
 {
-	if (checkExists(requredArg))
-		throw std::runtime_error("This argument has already been added");
-	requiredArgs.push_back(requredArg);
-	return *this;
+	std::uint8_t flags = ParserPlan::required;
+	if (requredArg.hasContent())
+		flags |= ParserPlan::hasContent;
+	return add(requredArg, flags, nullptr);
+}
+
+ArgsManager& ArgsManager::addRequired(const Argument& requredArg, ArgId& id)
+{
+	std::uint8_t flags = ParserPlan::required;
+	if (requredArg.hasContent())
+		flags |= ParserPlan::hasContent;
+	return add(requredArg, flags, &id);
 }
 
 ArgsManager& ArgsManager::addOptional(const Argument& optionalArg)
 {
-	if (checkExists(optionalArg))
-		throw std::runtime_error("This argument has already been added");
-	optionalArgs.push_back(optionalArg);
-	return *this;
+	std::uint8_t flags = 0;
+	if (optionalArg.hasContent())
+		flags |= ParserPlan::hasContent;
+	return add(optionalArg, flags, nullptr);
+}
+
+ArgsManager& ArgsManager::addOptional(const Argument& optionalArg, ArgId& id)
+{
+	std::uint8_t flags = 0;
+	if (optionalArg.hasContent())
+		flags |= ParserPlan::hasContent;
+	return add(optionalArg, flags, &id);
 }
 
 ArgsManager& ArgsManager::addRequiredToSet(const Argument& arg)
 {
-	if (checkExists(arg))
-		throw std::runtime_error("This argument has already been added");
-	requiredArgSet.push_back(arg);
-	return *this;
+	std::uint8_t flags = ParserPlan::requiredSet;
+	if (arg.hasContent())
+		flags |= ParserPlan::hasContent;
+	return add(arg, flags, nullptr);
+}
+
+ArgsManager& ArgsManager::addRequiredToSet(const Argument& arg, ArgId& id)
+{
+	std::uint8_t flags = ParserPlan::requiredSet;
+	if (arg.hasContent())
+		flags |= ParserPlan::hasContent;
+	return add(arg, flags, &id);
 }
 
 void ArgsManager::clear()
 {
-	requiredArgs.clear();
-	requiredArgSet.clear();
-	optionalArgs.clear();
-	argContentList.clear();
+	arguments.clear();
+	argumentFlags.clear();
+	registeredNames.clear();
+	plan.reset();
+	result.reset();
+	lazyResult.reset();
 }
 
-void ArgsManager::parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx = 0)
+ArgId ArgsManager::argId(const Argument& arg) const
 {
-	if (argc == 0 && (!requiredArgs.empty() || !requiredArgSet.empty())) {
-		throw InvalidArg("Does not pass a list of arguments.");
-	}
+	auto found = registeredNames.find(arg.getArg1());
+	if (found == registeredNames.end() && !arg.getArg2().empty())
+		found = registeredNames.find(arg.getArg2());
 
-	if (argc > 0) {
-		if (argv == nullptr)
-			throw std::invalid_argument("Pointer argv is NULL!");
-	}
+	if (found == registeredNames.end())
+		throw std::invalid_argument("Parameter " + arg.quotedNames() + " is not registered!");
+	return found->second;
+}
 
-	if (beginIdx > argc)
-		throw std::invalid_argument("Start index out of bounds.");
+std::shared_ptr<const ParserPlan> ArgsManager::freeze()
+{
+	if (!plan)
+		plan = std::allocate_shared<ParserPlan>(std::pmr::polymorphic_allocator<ParserPlan>(resource),
+			arguments, argumentFlags, resource, nameTable);
+	return plan;
+}
 
-	std::string exceptionMessage;
-	parsed = true;
+void ArgsManager::setContentMode(ContentMode mode)
+{
+	options.content = mode;
+}
 
-	// Required arguments
-	if (!requiredArgs.empty()) {
+void ArgsManager::setResponseFiles(bool enable)
+{
+	options.responseFiles = enable;
+}
 
-		for (const auto& requiredParam : requiredArgs) {
-			bool paramFound = false;
+void ArgsManager::setEnvironment(const char* const* environment)
+{
+	options.environment = environment;
+}
 
-			for (unsigned int idx = beginIdx; idx < argc; ++idx) {
-				const char* const paramStr = argv[idx];
+void ArgsManager::setStrict(bool enable)
+{
+	options.strict = enable;
+}
 
-				if (paramStr == nullptr)
-					throw std::runtime_error("Argument " + std::to_string(idx + 1) + " is NULL");
+void ArgsManager::setOptionsTerminator(bool enable)
+{
+	options.optionsTerminator = enable;
+}
 
-				if (requiredParam == Argument(paramStr)) {
-					paramFound = true;
+ArgsManager& ArgsManager::setNameTable(const NameTable* table)
+{
+	nameTable = table;
+	plan.reset();
+	return *this;
+}
 
-					Content content;
+ArgsManager& ArgsManager::addConfigFile(const std::string& path)
+{
+	ConfigFile file;
+	if (!file.open(path.c_str()))
+		throw InvalidArg("Configuration file '" + path + "' cannot be read.");
 
-					if (requiredParam.hasContent())
-						content = getContent(requiredParam, argc, idx, argv);
+	configFiles.push_back(std::move(file));
+	options.configFiles = configFiles.data();
+	options.configCount = configFiles.size();
+	return *this;
+}
 
-					// Fill
-					argContentList.push_back({ requiredParam, content });
-					break;
-				}
-			}
+void ArgsManager::clearConfigFiles()
+{
+	result.reset();
+	lazyResult.reset();
 
-			if (!paramFound) {
-				const auto& p2 = requiredParam.getArg2();
-				exceptionMessage
-					.append("Parameter '")
-					.append(requiredParam.getArg1() + ((!p2.empty()) ? "' / '" + p2 + "'" : "'"))
-					.append(" not found!");
-				throw InvalidArg(exceptionMessage);
-			}
-		}
+	configFiles.clear();
+	options.configFiles = nullptr;
+	options.configCount = 0;
+}
+
+void ArgsManager::setLazy(bool enable)
+{
+	lazy = enable;
+}
+
+void ArgsManager::parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx = 0)
+{
+	// The parses the lazy result declines are parsed eagerly
+	if (lazy) {
+		result.reset();
+		if (lazyResult.parse(freeze(), argc, argv, beginIdx, options))
+			return;
 	}
 
-	// Required arguments set
-	if (!requiredArgSet.empty()) {
-		bool paramFound = false;
+	lazyResult.reset();
+	freeze()->parse(argc, argv, beginIdx, result, options);
+}
 
-		for (const auto& requiredParam : requiredArgSet) {
+ParseOutcome ArgsManager::tryParseAll(const unsigned int argc, const char* const argv[], unsigned int beginIdx) noexcept
+{
+	lazyResult.reset();
 
-			for (unsigned int idx = beginIdx; idx < argc; ++idx) {
-				const char* const paramStr = argv[idx];
+	try {
+		freeze();
+	}
+	catch (...) {
+		result.reset();
+		return ParseOutcome(nullptr, result, { ParseErrc::outOfMemory });
+	}
+
+	return plan->tryParseAll(argc, argv, beginIdx, result, options);
+}
+
+void ArgsManager::parseCommandLine(std::string& commandLine)
+{
+	lazyResult.reset();
+	freeze()->parseCommandLine(commandLine, result, options);
+}
 
-				if (paramStr == nullptr)
-					throw std::runtime_error("Parameter " + std::to_string(idx + 1) + " is NULL");
+const ParseResult& ArgsManager::getResult() const noexcept
+{
+	return result;
+}
 
-				if (requiredParam == Argument(paramStr)) {
-					paramFound = true;
+const ParseStats& ArgsManager::getStats() const noexcept
+{
+	return result.stats();
+}
 
-					Content content;
+ParseStats ArgsManager::getCumulativeStats() const noexcept
+{
+	return plan ? plan->cumulativeStats() : ParseStats();
+}
 
-					if (requiredParam.hasContent())
-						content = getContent(requiredParam, argc, idx, argv);
+Content ArgsManager::argValue(const Argument& arg) const
+{
+	if (lazyResult.parsed()) {
+		const ArgId id = lazyResult.indexOf(arg);
+		if (id == ParserPlan::npos)
+			throw InvalidArg("Parameter " + arg.quotedNames() + " not found!");
+		return lazyResult.argValue(id);
+	}
 
-					// Fill
-					argContentList.push_back({ requiredParam, content });
-					break;
-				}
-			}
-		}
+	return result.argValue(arg);
+}
 
-		if (!paramFound) {
-			exceptionMessage = "Required argument not found.";
-			throw InvalidArg(exceptionMessage);
-		}
+Content ArgsManager::argValue(ArgId id) const
+{
+	return lazyResult.parsed() ? lazyResult.argValue(id) : result.argValue(id);
+}
 
+ValueRange ArgsManager::argValues(const Argument& arg) const
+{
+	if (lazyResult.parsed()) {
+		const ArgId id = lazyResult.indexOf(arg);
+		if (id == ParserPlan::npos)
+			throw InvalidArg("Parameter " + arg.quotedNames() + " not found!");
+		return lazyResult.argValues(id);
 	}
 
-	// Optional arguments
-	if (!optionalArgs.empty()) {
+	return result.argValues(arg);
+}
 
-		for (const auto& optionParam : optionalArgs) {
+ValueRange ArgsManager::argValues(ArgId id) const
+{
+	return lazyResult.parsed() ? lazyResult.argValues(id) : result.argValues(id);
+}
 
-			for (unsigned int idx = beginIdx; idx < argc; ++idx) {
-				const char* const paramStr = argv[idx];
+std::int64_t ArgsManager::argInt(ArgId id, std::size_t idx) const
+{
+	if (lazyResult.parsed())
+		return lazyResult.typedValue(id, idx, ValueType::integer).integer;
 
-				if (paramStr == nullptr)
-					throw std::runtime_error("Argument " + std::to_string(idx + 1) + " is NULL");
+	return result.argInt(id, idx);
+}
 
-				if (optionParam == Argument(paramStr)) {
+double ArgsManager::argFloat(ArgId id, std::size_t idx) const
+{
+	if (lazyResult.parsed())
+		return lazyResult.typedValue(id, idx, ValueType::floating).floating;
 
-					Content content;
+	return result.argFloat(id, idx);
+}
 
-					if (optionParam.hasContent())
-						content = getContent(optionParam, argc, idx, argv);
+bool ArgsManager::argBool(ArgId id, std::size_t idx) const
+{
+	if (lazyResult.parsed())
+		return lazyResult.typedValue(id, idx, ValueType::boolean).integer != 0;
 
-					// Fill
-					argContentList.push_back({ optionParam, content });
-					break;
-				}
-			}
-		}
-	}
+	return result.argBool(id, idx);
 }
 
-Content ArgsManager::argValue(const Argument& arg) const
+std::uint64_t ArgsManager::argBytes(ArgId id, std::size_t idx) const
 {
-	if (!parsed)
-		throw std::runtime_error("Parsing failed");
+	if (lazyResult.parsed())
+		return static_cast<std::uint64_t>(lazyResult.typedValue(id, idx, ValueType::byteSize).integer);
 
-	const ArgContent* argContent=nullptr;
-	for (const auto& it : argContentList) {
-		if (it.arg == arg)
-			argContent = &it;
-	}
+	return result.argBytes(id, idx);
+}
 
-	std::string exceptionMessage;
-	const auto& p2 = arg.getArg2();
+std::chrono::nanoseconds ArgsManager::argDuration(ArgId id, std::size_t idx) const
+{
+	if (lazyResult.parsed())
+		return std::chrono::nanoseconds(lazyResult.typedValue(id, idx, ValueType::duration).integer);
 
-	if (argContent == nullptr) {
-		exceptionMessage
-			.append("Parameter '")
-			.append(arg.getArg1() + ((!p2.empty()) ? "' / '" + p2 + "'" : "'"))
-			.append(" not found!");
-		throw InvalidArg(exceptionMessage);
-	}
+	return result.argDuration(id, idx);
+}
 
-	if (!argContent->arg.hasContent()) {
-		exceptionMessage
-			.append("Parameter '")
-			.append(arg.getArg1() + ((!p2.empty()) ? "' / '" + p2 + "'" : "'"))
-			.append(" has no content!");
-		throw std::runtime_error(exceptionMessage);
-	}
+std::size_t ArgsManager::argChoice(ArgId id, std::size_t idx) const
+{
+	if (lazyResult.parsed())
+		return static_cast<std::size_t>(lazyResult.typedValue(id, idx, ValueType::choice).integer);
 
-	return argContent->content;
+	return result.argChoice(id, idx);
 }
 
 bool ArgsManager::argPresent(const Argument& arg) const
 {
-	if (!parsed)
-		throw std::runtime_error("Parsing failed");
-
-	for (const auto& argItem : argContentList) {
-		if (argItem.arg == arg)
-			return true;
+	if (lazyResult.parsed()) {
+		const ArgId id = lazyResult.indexOf(arg);
+		return id != ParserPlan::npos && lazyResult.argPresent(id);
 	}
-	return false;
+
+	return result.argPresent(arg);
+}
+
+bool ArgsManager::argPresent(ArgId id) const
+{
+	return lazyResult.parsed() ? lazyResult.argPresent(id) : result.argPresent(id);
+}
+
+std::uint32_t ArgsManager::argOccurrences(ArgId id) const
+{
+	return lazyResult.parsed() ? lazyResult.argOccurrences(id) : result.argOccurrences(id);
+}
+
+ValueSource ArgsManager::argSource(ArgId id) const
+{
+	return lazyResult.parsed() ? lazyResult.argSource(id) : result.argSource(id);
 }
 
 bool ArgsManager::isHelpArg(const unsigned int argc, const char* const argv[], unsigned int beginIdx) const
@@ -1,14 +1,33 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include <iostream>
-#include <list>
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <memory>
+#include <memory_resource>
 
 #include "InvalidArg.h"
+#include "TypedValue.h"
 #include "Argument.h"
+#include "ParserPlan.h"
+#include "ParseResult.h"
+#include "ParseError.h"
+#include "ParseStats.h"
+#include "Matcher.h"
+#include "ParseOutcome.h"
+#include "IncrementalParser.h"
+#include "BatchParser.h"
+#include "Tokenizer.h"
+#include "TokenClassifier.h"
+#include "MappedFile.h"
+#include "ConfigFile.h"
+#include "Command.h"
+#include "LazyResult.h"
+#include "NameTable.h"
 
 /**
 	@mainpage
@@ -19,44 +38,71 @@
 	To use the library, you need to copy it, add it to the project and include the ArgsManager.h file
 */
 
-using Content = std::string;
-struct ArgContent{Argument arg; Content content;};
-using ArgContentList = std::list<ArgContent>;
-
 /**
 	@brief
 	Provides options for registering arguments, parsing them, validating them, extracting content.
-	The class implements the singleton pattern.
+	Instances are independent of each other and can be used from different threads at the same time;
+	getInstance() returns a global instance for convenience.
+	To parse concurrently with one set of arguments, share the plan returned by freeze()
+	and parse into a separate ParseResult per thread.
 */
 class ArgsManager
 {
 
 private:
 
-	ArgsManager() = default;
-	std::vector<Argument>
-		requiredArgs
-		, optionalArgs
-		, requiredArgSet;
+	std::pmr::memory_resource* resource;
+
+	std::pmr::vector<Argument> arguments;
+	std::pmr::vector<std::uint8_t> argumentFlags;
+	std::pmr::unordered_map<std::string, ArgId> registeredNames;
+	std::shared_ptr<const ParserPlan> plan;
+	const NameTable* nameTable = nullptr;
 
-	ArgContentList argContentList;
+	ParseResult result;
+	ParseOptions options;
 
-	Content getContent(const Argument& argument,
-		const unsigned int argc, const unsigned int idx, const char* const argv[]) const;
+	// Configuration files of the parses, viewed by options
+	std::pmr::vector<ConfigFile> configFiles;
 
-	std::unordered_set<std::string> helpArgs;
-	bool parsed = false;
+	LazyResult lazyResult;
+	bool lazy = false;
 
-	bool checkExists(const Argument& argument);
+	std::pmr::unordered_set<std::string> helpArgs;
+
+	bool checkExists(const Argument& argument) const;
+	ArgsManager& add(const Argument& arg, std::uint8_t flags, ArgId* id);
 
 public:
+	/**
+		@brief constructor, the storage is allocated from the default memory resource.
+	*/
+	ArgsManager();
+
+	/**
+		@brief constructor.
+		@param resource memory resource of the registered arguments, the plan and the parse results,
+		must outlive the instance and the plans and results obtained from it.
+		The names of the arguments are stored in std::string.
+	*/
+	explicit ArgsManager(std::pmr::memory_resource* resource);
+
 	ArgsManager(const ArgsManager&) = delete;
-	ArgsManager(const ArgsManager&&) = delete;
-	void operator=(const ArgsManager&) = delete;
-	void operator=(const ArgsManager&&) = delete;
+	/**
+		@brief Move constructor, the configuration files added to other are moved into the instance.
+	*/
+	ArgsManager(ArgsManager&& other);
+	ArgsManager& operator=(const ArgsManager&) = delete;
+
+	/**
+		@brief Move semantics operator=, the instance keeps its memory resource, as std::pmr containers do.
+		If the memory resources differ, the arguments and the parse result are copied into the resource of this instance,
+		the plan is built again and a lazy parse is dropped.
+	*/
+	ArgsManager& operator=(ArgsManager&& other);
 
 	/**
-		@brief Returns an instance of this class.
+		@brief Returns the global instance of this class.
 		@return instance of this calss.
 	*/
 	static ArgsManager& getInstance();
@@ -76,6 +122,14 @@ public:
 	*/
 	ArgsManager& addRequired(const Argument& arg);
 
+	/**
+		@brief Add required argument.
+		@return instance of this calss.
+		@param arg added required argument.
+		@param id receives the handle of the added argument.
+	*/
+	ArgsManager& addRequired(const Argument& arg, ArgId& id);
+
 	/**
 		@brief Add a required argument.
 		@return instance of this calss.
@@ -84,6 +138,15 @@ public:
 	*/
 	ArgsManager& addRequiredToSet(const Argument& arg);
 
+	/**
+		@brief Add a required argument.
+		@return instance of this calss.
+		At least one argument added with this method must be passed.
+		@param arg added required argument.
+		@param id receives the handle of the added argument.
+	*/
+	ArgsManager& addRequiredToSet(const Argument& arg, ArgId& id);
+
 	/**
 		@brief Add an optional argument.
 		@return Instance of this calss.
@@ -91,11 +154,100 @@ public:
 	*/
 	ArgsManager& addOptional(const Argument& optionalArg);
 
+	/**
+		@brief Add an optional argument.
+		@return Instance of this calss.
+		@param optionalArg added optional argument.
+		@param id receives the handle of the added argument.
+	*/
+	ArgsManager& addOptional(const Argument& optionalArg, ArgId& id);
+
+	/**
+		@brief Returns the handle of a registered argument.
+		@return Handle of the argument.
+		@throw arg was not registered.
+		@param arg argument matching at least one name of the registered argument.
+	*/
+	ArgId argId(const Argument& arg) const;
+
 	/**
 		@brief Clear the set of all argument.
 	*/
 	void clear();
 
+	/**
+		@brief Compiles the registered arguments into an immutable plan.
+		The plan is reused by every following parse until another argument is registered or clear() is called.
+		@return Plan of the registered arguments.
+	*/
+	std::shared_ptr<const ParserPlan> freeze();
+
+	/**
+		@brief Sets the storage of the content extracted by the following calls of parse().
+		@param mode storage of the content, ContentMode::copy by default.
+	*/
+	void setContentMode(ContentMode mode);
+
+	/**
+		@brief Enables the expansion of the tokens @path by the tokens of the response file (see ParseOptions).
+		@param enable TRUE to expand the response files, FALSE by default.
+	*/
+	void setResponseFiles(bool enable);
+
+	/**
+		@brief Sets the environment read by the arguments which are not passed (see Argument::setEnv() and ParseOptions).
+		@param environment NAME=VALUE strings terminated by NULL, must outlive the parse results.
+		NULL for the environment of the process (default).
+	*/
+	void setEnvironment(const char* const* environment);
+
+	/**
+		@brief Reports the unknown options and accepts the unique abbreviations of the long names (see ParseOptions::strict).
+		A strict parse is never lazy.
+		@param enable TRUE to parse strictly, FALSE by default.
+	*/
+	void setStrict(bool enable);
+
+	/**
+		@brief Ends the options at the token "--" (see ParseOptions::optionsTerminator).
+		@param enable TRUE to end the options at "--", FALSE by default.
+	*/
+	void setOptionsTerminator(bool enable);
+
+	/**
+		@brief Replaces the index of the names of the plan by a generated perfect hash table (see NameTable).
+		The arguments must be registered in the order of the table, usually by the registerTo() function
+		of the generated header.
+		@return Reference to this instance.
+		@param table generated table, must outlive the plans; NULL to index the names again.
+	*/
+	ArgsManager& setNameTable(const NameTable* table);
+
+	/**
+		@brief Adds a configuration file (see ConfigFile), mapped and indexed once.
+		The arguments missing from the command line are read from the files, then from the environment;
+		a file added later overrides the files added before it.
+		With ContentMode::view the content points into the mapped file, until clearConfigFiles() is called.
+		@return Reference to this instance.
+		@throw If the file cannot be read.
+		@param path path of the file.
+	*/
+	ArgsManager& addConfigFile(const std::string& path);
+
+	/**
+		@brief Removes the configuration files, the results of the previous parses are cleared.
+	*/
+	void clearConfigFiles();
+
+	/**
+		@brief Enables the lazy parsing (see LazyResult): the tokens are matched on the first access,
+		or by parse() if it checks required arguments; the content is converted on the first access and memoized.
+		The errors of the tokens of a deferred match are reported by every access. The content points into argv.
+		The parses declined by LazyResult and parseCommandLine() are eager.
+		@param enable TRUE to parse lazily, FALSE by default.
+	*/
+	void setLazy(bool enable);
+
 	/**
 		@brief Performs parsing of passed arguments, validation of input arguments, and extraction of argument values.
 		@throw If argc == 0, beginIdx > argc, argv is NULL pointer.
@@ -105,14 +257,122 @@ public:
 	*/
 	void parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx);
 
+	/**
+		@brief Performs parsing without throwing and collects all errors in one pass (see ParserPlan::tryParseAll()).
+		The parse is never lazy.
+		@return Outcome holding the result or the errors, valid until the next parse.
+		@param argc count of arguments.
+		@param argv arguments array.
+		@param beginIdx initial argument number.
+	*/
+	ParseOutcome tryParseAll(const unsigned int argc, const char* const argv[], unsigned int beginIdx) noexcept;
+
+	/**
+		@brief Performs parsing of a whole command line, tokenized in place with the shell rules (see Tokenizer).
+		@throw If an argument or content is not found or a quote is not terminated.
+		@param commandLine command line, modified by the tokenization.
+		With ContentMode::view it must outlive the extracted content.
+	*/
+	void parseCommandLine(std::string& commandLine);
+
+	/**
+		@brief Returns the result of the last call of parse(), unparsed after a lazy parse.
+	*/
+	const ParseResult& getResult() const noexcept;
+
+	/**
+		@brief Returns the counters of the last parse, zero unless the library is built with ARGSMANAGER_STATS.
+		A lazy parse is not counted.
+	*/
+	const ParseStats& getStats() const noexcept;
+
+	/**
+		@brief Returns the sum of the counters of the parses since the registered arguments last changed,
+		zero unless the library is built with ARGSMANAGER_STATS.
+	*/
+	ParseStats getCumulativeStats() const noexcept;
+
 	/**
 		@brief Extract content from instance of ArgContentMap. Method parse() must be called before this method.
-		@return Instance of ArgContent, contains the conent for the specified argument.
+		@return View of the content for the specified argument, no copy is made. See ContentMode for its lifetime.
 		@throw arg Not found, has no content or method parse() was not called.
 		@param arg argument for which the content should be retrieved.
 	*/
 	Content argValue(const Argument& arg) const;
 
+	/**
+		@brief Extract content of the argument with the specified handle. Method parse() must be called before this method.
+		@return View of the content for the specified argument, no copy is made. See ContentMode for its lifetime.
+		@throw id is out of range, argument not found, has no content or method parse() was not called.
+		@param id handle of the argument returned on registration.
+	*/
+	Content argValue(ArgId id) const;
+
+	/**
+		@brief Returns all content values of the argument (see Argument::setRepeatable() and Argument::setArity()).
+		Method parse() must be called before this method.
+		@return Range of the values, empty if the argument is not present. See ContentMode for the lifetime of the values.
+		@throw arg Not found, has no content or method parse() was not called.
+		@param arg argument for which the values should be retrieved.
+	*/
+	ValueRange argValues(const Argument& arg) const;
+
+	/**
+		@brief Returns all content values of the argument with the specified handle. Method parse() must be called before this method.
+		@return Range of the values, empty if the argument is not present. See ContentMode for the lifetime of the values.
+		@throw id is out of range, the argument has no content or method parse() was not called.
+		@param id handle of the argument returned on registration.
+	*/
+	ValueRange argValues(ArgId id) const;
+
+	/**
+		@brief Returns the value of the argument of type ValueType::integer. Method parse() must be called before this method.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+		@param idx index of the value in argValues().
+	*/
+	std::int64_t argInt(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the value of the argument of type ValueType::floating. Method parse() must be called before this method.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+		@param idx index of the value in argValues().
+	*/
+	double argFloat(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the value of the argument of type ValueType::boolean. Method parse() must be called before this method.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+		@param idx index of the value in argValues().
+	*/
+	bool argBool(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the count of bytes of the argument of type ValueType::byteSize. Method parse() must be called before this method.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+		@param idx index of the value in argValues().
+	*/
+	std::uint64_t argBytes(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the duration of the argument of type ValueType::duration. Method parse() must be called before this method.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+		@param idx index of the value in argValues().
+	*/
+	std::chrono::nanoseconds argDuration(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the index of the choice of the argument of type ValueType::choice. Method parse() must be called before this method.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+		@param idx index of the value in argValues().
+	*/
+	std::size_t argChoice(ArgId id, std::size_t idx = 0) const;
+
 	/**
 		@brief Checks if the argument is present in the passed arguments.
 		@return True if arguemnt is present in the passed arguments, otherwise false.
@@ -121,6 +381,30 @@ public:
 	*/
 	bool argPresent(const Argument& arg) const;
 
+	/**
+		@brief Checks if the argument with the specified handle is present in the passed arguments.
+		@return True if arguemnt is present in the passed arguments, otherwise false.
+		@throw If id is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+	*/
+	bool argPresent(ArgId id) const;
+
+	/**
+		@brief Returns how many times the argument with the specified handle is present in the passed arguments.
+		@return Count of occurrences, 0 if the argument is not present.
+		@throw If id is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+	*/
+	std::uint32_t argOccurrences(ArgId id) const;
+
+	/**
+		@brief Returns the source of the argument with the specified handle: the command line or the environment.
+		@return Source of the argument, ValueSource::none if the argument is not present.
+		@throw If id is out of range or method parse() was not called.
+		@param id handle of the argument returned on registration.
+	*/
+	ValueSource argSource(ArgId id) const;
+
 	/**
 		@brief Checks if input parameters are parameters for outputting help. Method parse() must be called before this method.
 		@return Returns true if argv contains a help parameter, false otherwise.
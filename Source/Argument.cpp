@@ -13,13 +13,13 @@ Argument::Argument(const std::string& arg1, const std::string& arg2) :
 }
 
 Argument::Argument(bool hasContent, const std::string& arg1, const std::string& arg2) :
-	arg1(arg1), arg2(arg2), has_Content(hasContent) {
+	arg1(arg1), arg2(arg2), has_Content(hasContent), arity(hasContent ? 1 : 0) {
 	if (arg1.empty())
 		throw std::invalid_argument(emptyArgsErrorMsg);
 }
 
 Argument::Argument(bool hasContent, std::string&& arg1, std::string&& arg2) :
-	arg1(std::move(arg1)), arg2(std::move(arg2)), has_Content(hasContent) {}
+	arg1(std::move(arg1)), arg2(std::move(arg2)), has_Content(hasContent), arity(hasContent ? 1 : 0) {}
 
 Argument::Argument(Argument&& arg) noexcept {
 	*this = std::move(arg);
@@ -30,6 +30,14 @@ Argument& Argument::operator=(Argument&& arg) noexcept {
 	arg2 = std::move(arg.arg2);
 	has_Content = arg.has_Content;
 	arg.has_Content = false;
+	repeatable = arg.repeatable;
+	arity = arg.arity;
+	type = arg.type;
+	choices = std::move(arg.choices);
+	envName = std::move(arg.envName);
+	arg.repeatable = false;
+	arg.arity = 0;
+	arg.type = ValueType::string;
 	return *this;
 }
 
@@ -45,6 +53,57 @@ bool Argument::hasContent() const {
 	return has_Content;
 }
 
+Argument& Argument::setArity(std::uint32_t count) noexcept {
+	arity = count;
+	has_Content = count != 0;
+	return *this;
+}
+
+std::uint32_t Argument::getArity() const noexcept {
+	return arity;
+}
+
+Argument& Argument::setRepeatable(bool enable) noexcept {
+	repeatable = enable;
+	return *this;
+}
+
+bool Argument::isRepeatable() const noexcept {
+	return repeatable;
+}
+
+Argument& Argument::setType(ValueType valueType) noexcept {
+	type = valueType;
+	return *this;
+}
+
+ValueType Argument::getType() const noexcept {
+	return type;
+}
+
+Argument& Argument::setChoices(std::vector<std::string> values) {
+	choices = std::move(values);
+	type = ValueType::choice;
+	return *this;
+}
+
+const std::vector<std::string>& Argument::getChoices() const noexcept {
+	return choices;
+}
+
+Argument& Argument::setEnv(std::string name) {
+	envName = std::move(name);
+	return *this;
+}
+
+const std::string& Argument::getEnv() const noexcept {
+	return envName;
+}
+
+std::string Argument::quotedNames() const {
+	return "'" + arg1 + ((!arg2.empty()) ? "' / '" + arg2 + "'" : "'");
+}
+
 bool Argument::operator==(const Argument& arg) const noexcept {
 	
 	if (!arg.getArg1().empty()) {
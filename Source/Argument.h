@@ -15,9 +15,19 @@ private:
 	std::string arg2;
 	static constexpr const char* emptyArgsErrorMsg = "Add argument cannot be empty!";
 	bool has_Content = false;
+	bool repeatable = false;
+	std::uint32_t arity = 0;
+	ValueType type = ValueType::string;
+	std::vector<std::string> choices;
+	std::string envName;
 
 public:
 
+	/**
+		@brief Arity of an argument taking all following content tokens (at least one).
+	*/
+	static constexpr std::uint32_t variadic = ~std::uint32_t(0);
+
 	/**
 		@brief constructor.
 		@throw If arg1 is empty.
@@ -78,6 +88,74 @@ public:
 	*/
 	bool hasContent() const;
 
+	/**
+		@brief Sets the count of content tokens following each occurrence of the argument.
+		@return Reference to this argument.
+		@param count count of content tokens, Argument::variadic to take all following content tokens,
+		0 for an argument without content.
+	*/
+	Argument& setArity(std::uint32_t count) noexcept;
+
+	/**
+		@brief Returns the count of content tokens following each occurrence, Argument::variadic or 0 without content.
+	*/
+	std::uint32_t getArity() const noexcept;
+
+	/**
+		@brief Sets whether the content of every occurrence is collected, by default only the first occurrence is used.
+		@return Reference to this argument.
+		@param enable TRUE to collect the content of every occurrence.
+	*/
+	Argument& setRepeatable(bool enable = true) noexcept;
+
+	/**
+		@brief Returns TRUE if the content of every occurrence is collected, otherwise FALSE.
+	*/
+	bool isRepeatable() const noexcept;
+
+	/**
+		@brief Sets the type of the content, the content is converted while parsing and read by the typed accessors.
+		@return Reference to this argument.
+		@param valueType type of the content.
+	*/
+	Argument& setType(ValueType valueType) noexcept;
+
+	/**
+		@brief Returns the type of the content.
+	*/
+	ValueType getType() const noexcept;
+
+	/**
+		@brief Sets the allowed values of the content, the type becomes ValueType::choice.
+		@return Reference to this argument.
+		@param values allowed values.
+	*/
+	Argument& setChoices(std::vector<std::string> values);
+
+	/**
+		@brief Returns the allowed values of the content.
+	*/
+	const std::vector<std::string>& getChoices() const noexcept;
+
+	/**
+		@brief Sets the environment variable read when the argument is not passed, for example: APP_OUTPUT.
+		The value of the variable is the content of the argument; an argument without content is passed
+		if the value is a true ValueType::boolean (true, yes, on, 1). At most one content token is allowed (arity 1 or variadic).
+		@return Reference to this argument.
+		@param name name of the environment variable, empty to read none.
+	*/
+	Argument& setEnv(std::string name);
+
+	/**
+		@brief Returns the name of the environment variable read when the argument is not passed, empty if there is none.
+	*/
+	const std::string& getEnv() const noexcept;
+
+	/**
+		@brief Returns the names of the argument for messages, for example: '-i' / '--input'.
+	*/
+	std::string quotedNames() const;
+
 	/**
 		@brief Returns TRUE if at least one argument matches, otherwise FALSE.
 		@param arg instance of Argument.
@@ -0,0 +1,295 @@
+#include "ArgsManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+void BatchResult::checkLine(std::size_t line) const
+{
+	if (line >= lineCount)
+		throw std::out_of_range("Line index out of range.");
+}
+
+std::size_t BatchResult::lines() const noexcept
+{
+	return lineCount;
+}
+
+ParseErrc BatchResult::error(std::size_t line) const
+{
+	checkLine(line);
+	return errors[line];
+}
+
+std::size_t BatchResult::errorCount() const noexcept
+{
+	return static_cast<std::size_t>(std::count_if(errors.begin(), errors.end(),
+		[](ParseErrc code) { return code != ParseErrc::none; }));
+}
+
+bool BatchResult::argPresent(std::size_t line, ArgId id) const
+{
+	checkLine(line);
+
+	if (id >= contentSlots.size())
+		throw std::out_of_range("Argument handle out of range.");
+
+	return (presence[line * wordCount + id / ParserPlan::wordBits] >> (id % ParserPlan::wordBits)) & 1;
+}
+
+std::uint32_t BatchResult::contentSlot(ArgId id) const
+{
+	if (id >= contentSlots.size())
+		throw std::out_of_range("Argument handle out of range.");
+
+	if (contentSlots[id] == ParserPlan::npos)
+		throw std::runtime_error("Parameter " + plan->argument(id).quotedNames() + " has no content!");
+
+	return contentSlots[id];
+}
+
+Content BatchResult::argValue(std::size_t line, ArgId id) const
+{
+	const ValueRange values = argValues(line, id);
+	return values.empty() ? Content() : values[0];
+}
+
+ValueRange BatchResult::argValues(std::size_t line, ArgId id) const
+{
+	checkLine(line);
+	const std::uint32_t slot = contentSlot(id);
+
+	const Content* const values = chunks[line / chunkSize].values.data();
+	const std::uint32_t* const begin = valueBegin.data() + line * (contentCount + 1);
+	return ValueRange(values + begin[slot], values + begin[slot + 1]);
+}
+
+/**
+	@brief
+	Threads of a BatchParser, waiting for the jobs of parse().
+*/
+class BatchParser::Workers
+{
+
+private:
+
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	// Job of the current run, taken by the wanted count of threads
+	const std::function<void()>* job = nullptr;
+	std::uint64_t generation = 0;
+	std::size_t wanted = 0;
+	std::size_t taken = 0;
+	std::size_t finished = 0;
+	bool stopping = false;
+
+	// One run at a time
+	std::mutex runMutex;
+
+	void loop()
+	{
+		std::uint64_t seen = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+
+		for (;;) {
+			wake.wait(lock, [&]() { return stopping || generation != seen; });
+			if (stopping)
+				return;
+
+			seen = generation;
+			if (taken == wanted)
+				continue;
+
+			++taken;
+			const std::function<void()>& current = *job;
+			lock.unlock();
+			current();
+			lock.lock();
+
+			if (++finished == wanted)
+				done.notify_one();
+		}
+	}
+
+public:
+
+	explicit Workers(std::size_t count)
+	{
+		threads.reserve(count);
+		try {
+			for (std::size_t idx = 0; idx < count; ++idx)
+				threads.emplace_back([this]() { loop(); });
+		}
+		catch (...) {
+			stop();
+			throw;
+		}
+	}
+
+	~Workers()
+	{
+		stop();
+	}
+
+	void stop() noexcept
+	{
+		{
+			const std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+
+		for (auto& thread : threads)
+			thread.join();
+		threads.clear();
+	}
+
+	/**
+		@brief Runs the job on helpers threads of the pool and on the calling thread, returns when all are done.
+		The job must not throw.
+	*/
+	void run(const std::function<void()>& task, std::size_t helpers)
+	{
+		const std::lock_guard<std::mutex> runLock(runMutex);
+		helpers = std::min(helpers, threads.size());
+
+		if (helpers > 0) {
+			const std::lock_guard<std::mutex> lock(mutex);
+			job = &task;
+			wanted = helpers;
+			taken = 0;
+			finished = 0;
+			++generation;
+		}
+		wake.notify_all();
+
+		task();
+
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [&]() { return finished == wanted; });
+		job = nullptr;
+		wanted = 0;
+		finished = 0;
+	}
+};
+
+BatchParser::BatchParser(std::shared_ptr<const ParserPlan> plan, unsigned int threadCount) :
+	plan(std::move(plan)), threadCount(threadCount)
+{
+	if (!this->plan)
+		throw std::invalid_argument("Pointer plan is NULL!");
+
+	if (this->threadCount == 0)
+		this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	workers = std::make_unique<Workers>(this->threadCount - 1);
+}
+
+BatchParser::~BatchParser() = default;
+BatchParser::BatchParser(BatchParser&&) noexcept = default;
+BatchParser& BatchParser::operator=(BatchParser&&) noexcept = default;
+
+BatchResult BatchParser::parse(const ArgvView* lines, std::size_t count, unsigned int beginIdx) const
+{
+	if (count > 0 && lines == nullptr)
+		throw std::invalid_argument("Pointer lines is NULL!");
+
+	if (!workers)
+		throw std::logic_error("The parser was moved from!");
+
+	BatchResult batch;
+	batch.plan = plan;
+	batch.lineCount = count;
+	batch.wordCount = plan->wordCount();
+
+	// Only the arguments with content get a column in the content table
+	std::vector<ArgId> contentIds;
+	batch.contentSlots.assign(plan->size(), ParserPlan::npos);
+	for (ArgId id = 0; id < plan->size(); ++id) {
+		if (plan->argumentFlags(id) & ParserPlan::hasContent) {
+			batch.contentSlots[id] = static_cast<std::uint32_t>(contentIds.size());
+			contentIds.push_back(id);
+		}
+	}
+	batch.contentCount = contentIds.size();
+
+	// Workers take chunks of lines, each chunk is written by exactly one worker
+	batch.chunkSize = 256;
+	const std::size_t chunkCount = (count + batch.chunkSize - 1) / batch.chunkSize;
+
+	batch.errors.assign(count, ParseErrc::none);
+	batch.presence.assign(count * batch.wordCount, 0);
+	batch.valueBegin.assign(count * (batch.contentCount + 1), 0);
+	batch.chunks.resize(chunkCount);
+
+	std::atomic<std::size_t> nextChunk(0);
+
+	std::mutex failureMutex;
+	std::exception_ptr failure;
+
+	const std::function<void()> worker = [&]() {
+		try {
+			ParseResult result;
+
+			for (;;) {
+				const std::size_t chunkIdx = nextChunk.fetch_add(1, std::memory_order_relaxed);
+				if (chunkIdx >= chunkCount)
+					break;
+
+				BatchResult::Chunk& chunk = batch.chunks[chunkIdx];
+				const std::size_t first = chunkIdx * batch.chunkSize;
+				const std::size_t last = std::min(count, first + batch.chunkSize);
+
+				for (std::size_t line = first; line < last; ++line) {
+					std::uint32_t* const begin = batch.valueBegin.data() + line * (batch.contentCount + 1);
+					begin[0] = static_cast<std::uint32_t>(chunk.values.size());
+
+					const ParseError error = plan->tryParse(lines[line].argc, lines[line].argv, beginIdx,
+						result, ContentMode::view);
+
+					batch.errors[line] = error.code;
+					if (!error) {
+						const auto& mask = result.presenceMask();
+						std::copy(mask.begin(), mask.end(), batch.presence.begin() + line * batch.wordCount);
+					}
+
+					for (std::size_t slot = 0; slot < contentIds.size(); ++slot) {
+						const ArgId id = contentIds[slot];
+						if (!error && result.argPresent(id)) {
+							// The values read from the environment are stored by the result, which is reused by the next line
+							const bool copy = result.argSource(id) == ValueSource::environment;
+							for (const Content value : result.argValues(id))
+								chunk.values.push_back(copy ? Content(chunk.stored.emplace_front(value)) : value);
+						}
+
+						begin[slot + 1] = static_cast<std::uint32_t>(chunk.values.size());
+					}
+				}
+			}
+		}
+		catch (...) {
+			const std::lock_guard<std::mutex> lock(failureMutex);
+			if (!failure)
+				failure = std::current_exception();
+
+			// Stop the other workers
+			nextChunk = chunkCount;
+		}
+	};
+
+	const std::size_t workerCount = std::min<std::size_t>(threadCount, chunkCount);
+	workers->run(worker, (workerCount > 1) ? workerCount - 1 : 0);
+
+	if (failure)
+		std::rethrow_exception(failure);
+
+	return batch;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <forward_list>
+#include <iterator>
+#include <string>
+#include <memory>
+#include <vector>
+
+#include "ParserPlan.h"
+#include "ParseResult.h"
+#include "ParseError.h"
+
+/**
+	@brief Arguments of one command line: argc and argv.
+*/
+struct ArgvView {
+	unsigned int argc = 0;
+	const char* const* argv = nullptr;
+};
+
+/**
+	@brief
+	Results of a batch parse, stored compactly for each line:
+	the error code, the presence bits and the content values of the arguments that take content.
+	The content points into the parsed argv, which must outlive the result;
+	the values read from the environment are copied into the result.
+*/
+class BatchResult
+{
+
+	friend class BatchParser;
+
+private:
+
+	// Values of a chunk of lines, written by one worker
+	struct Chunk {
+		std::vector<Content> values;
+
+		// Copies of the values read from the environment, the nodes are never moved
+		std::forward_list<std::string> stored;
+	};
+
+	std::size_t lineCount = 0;
+	std::size_t wordCount = 0;
+	std::size_t contentCount = 0;
+	std::size_t chunkSize = 0;
+
+	std::shared_ptr<const ParserPlan> plan;
+	std::vector<std::uint32_t> contentSlots;
+
+	std::vector<ParseErrc> errors;
+	std::vector<std::uint64_t> presence;
+
+	// Values of the slot of a line are [valueBegin[slot], valueBegin[slot + 1]) of the values of its chunk,
+	// contentCount + 1 entries per line
+	std::vector<std::uint32_t> valueBegin;
+	std::vector<Chunk> chunks;
+
+	void checkLine(std::size_t line) const;
+	std::uint32_t contentSlot(ArgId id) const;
+
+public:
+
+	/**
+		@brief Returns the count of parsed lines.
+	*/
+	std::size_t lines() const noexcept;
+
+	/**
+		@brief Returns the error of the line, ParseErrc::none if the line is valid.
+		@throw line is out of range.
+		@param line index of the line.
+	*/
+	ParseErrc error(std::size_t line) const;
+
+	/**
+		@brief Returns the count of lines with errors.
+	*/
+	std::size_t errorCount() const noexcept;
+
+	/**
+		@brief Checks if the argument is present in the line.
+		@return True if arguemnt is present in the line, otherwise false.
+		@throw line or id is out of range.
+		@param line index of the line.
+		@param id handle of the argument.
+	*/
+	bool argPresent(std::size_t line, ArgId id) const;
+
+	/**
+		@brief Extract content of the argument in the line.
+		@return View of the first content value into the argv of the line, empty if the argument is not present.
+		@throw line or id is out of range, the argument has no content.
+		@param line index of the line.
+		@param id handle of the argument.
+	*/
+	Content argValue(std::size_t line, ArgId id) const;
+
+	/**
+		@brief Returns all content values of the argument in the line: every value of a repeatable argument or of an argument with arity.
+		@return Range of the values, empty if the argument is not present; valid as long as the result.
+		@throw line or id is out of range, the argument has no content.
+		@param line index of the line.
+		@param id handle of the argument.
+	*/
+	ValueRange argValues(std::size_t line, ArgId id) const;
+};
+
+/**
+	@brief
+	Parses many command lines against one shared plan using a pool of worker threads.
+	The threads are started by the constructor and wait for the batches, the calling thread also takes part.
+	Each worker reuses its own ParseResult, so the lines are parsed without allocations
+	and without synchronization besides taking the next chunk of lines.
+	The batches of concurrent calls of parse() are parsed one after the other.
+*/
+class BatchParser
+{
+
+private:
+
+	class Workers;
+
+	std::shared_ptr<const ParserPlan> plan;
+	unsigned int threadCount;
+	std::unique_ptr<Workers> workers;
+
+public:
+
+	/**
+		@brief constructor, starts threadCount - 1 worker threads.
+		@throw If plan is NULL.
+		@param plan plan shared by all workers.
+		@param threadCount count of worker threads, 0 to use the count of hardware threads.
+	*/
+	explicit BatchParser(std::shared_ptr<const ParserPlan> plan, unsigned int threadCount = 0);
+
+	/**
+		@brief destructor, stops the worker threads.
+	*/
+	~BatchParser();
+
+	BatchParser(BatchParser&&) noexcept;
+	BatchParser& operator=(BatchParser&&) noexcept;
+	BatchParser(const BatchParser&) = delete;
+	BatchParser& operator=(const BatchParser&) = delete;
+
+	/**
+		@brief Parses the command lines.
+		@return Result of each line.
+		@param lines command lines.
+		@param count count of command lines.
+		@param beginIdx initial argument number of each line.
+	*/
+	BatchResult parse(const ArgvView* lines, std::size_t count, unsigned int beginIdx = 0) const;
+
+	/**
+		@brief Parses the command lines.
+		@return Result of each line.
+		@param lines range of command lines, each element is a contiguous container of const char*
+		(for example std::vector<const char*>).
+		@param beginIdx initial argument number of each line.
+	*/
+	template <typename Range>
+	BatchResult parse(const Range& lines, unsigned int beginIdx = 0) const
+	{
+		std::vector<ArgvView> views;
+		views.reserve(static_cast<std::size_t>(std::distance(std::begin(lines), std::end(lines))));
+
+		for (const auto& line : lines)
+			views.push_back({ static_cast<unsigned int>(std::size(line)), std::data(line) });
+
+		return parse(views.data(), views.size(), beginIdx);
+	}
+};
@@ -0,0 +1,504 @@
+/**
+	Benchmark of the library: parse throughput as the count of tokens and of registered options grows,
+	latency of the lookups, cost of the registration, of the classification of the tokens, of the name lookup
+	(hash map or generated NameTable), of Argument::operator== and of the suggestions for a mistyped name.
+
+	Usage: ArgsManagerBenchmark [--format=json|csv] [--filter=<substring>] [--quick]
+	The results are written to stdout, one record per case, to be compared between releases.
+*/
+
+#include "ArgsManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Record {
+		std::string name;
+		std::size_t tokens = 0;
+		std::size_t options = 0;
+		std::uint64_t iterations = 0;
+		double nsPerOp = 0;
+	};
+
+	struct Settings {
+		bool json = true;
+		bool quick = false;
+		std::string filter;
+	};
+
+	// Prevents the compiler from removing the measured work
+	volatile std::size_t sink = 0;
+
+	/**
+		@brief Runs the operation until the minimal time is spent, repeats the measurement and keeps the best.
+		@return Nanoseconds per operation.
+		@param opsPerCall count of operations performed by one call of the function.
+	*/
+	template<typename Function>
+	double measure(const Settings& settings, std::size_t opsPerCall, std::uint64_t& iterations, Function&& function)
+	{
+		const auto minTime = settings.quick ? std::chrono::milliseconds(5) : std::chrono::milliseconds(200);
+		const int repeats = settings.quick ? 1 : 3;
+
+		// Warm up, the first call also allocates the storage reused by the next ones
+		function();
+
+		double best = 0;
+		for (int repeat = 0; repeat < repeats; ++repeat) {
+			std::uint64_t calls = 0;
+			const auto begin = Clock::now();
+			auto elapsed = Clock::duration::zero();
+
+			do {
+				function();
+				++calls;
+				elapsed = Clock::now() - begin;
+			} while (elapsed < minTime);
+
+			const double ns = std::chrono::duration<double, std::nano>(elapsed).count() / (double(calls) * opsPerCall);
+			if (repeat == 0 || ns < best) {
+				best = ns;
+				iterations = calls * opsPerCall;
+			}
+		}
+
+		return best;
+	}
+
+	std::string optionName(std::size_t idx)
+	{
+		return "--option" + std::to_string(idx);
+	}
+
+	/**
+		@brief Registers the optional arguments with content, --option0 .. --optionN.
+	*/
+	void registerOptions(ArgsManager& manager, std::size_t count, std::vector<ArgId>& ids)
+	{
+		ids.resize(count);
+		for (std::size_t idx = 0; idx < count; ++idx)
+			manager.addOptional(Argument(true, optionName(idx)), ids[idx]);
+	}
+
+	/**
+		@brief Command line of the option/value pairs cycling through the registered options.
+	*/
+	class CommandLine
+	{
+
+	private:
+
+		std::vector<std::string> storage;
+		std::vector<const char*> pointers;
+
+	public:
+
+		CommandLine(std::size_t tokens, std::size_t options)
+		{
+			storage.reserve(tokens);
+			for (std::size_t idx = 0; storage.size() < tokens; ++idx) {
+				storage.push_back(optionName(idx % options));
+				if (storage.size() < tokens)
+					storage.push_back("value" + std::to_string(idx));
+			}
+
+			// Dangling option at the end expects the content, it is completed by a value
+			if (tokens % 2 != 0)
+				storage.back() = "value";
+
+			pointers.reserve(storage.size());
+			for (const auto& token : storage)
+				pointers.push_back(token.c_str());
+		}
+
+		unsigned int argc() const noexcept { return static_cast<unsigned int>(pointers.size()); }
+		const char* const* argv() const noexcept { return pointers.data(); }
+	};
+
+	class Runner
+	{
+
+	private:
+
+		const Settings& settings;
+		std::vector<Record> records;
+
+		bool selected(const std::string& name) const
+		{
+			return settings.filter.empty() || name.find(settings.filter) != std::string::npos;
+		}
+
+	public:
+
+		explicit Runner(const Settings& settings) : settings(settings) {}
+
+		template<typename Function>
+		void run(const std::string& name, std::size_t tokens, std::size_t options, std::size_t opsPerCall,
+			Function&& function)
+		{
+			if (!selected(name))
+				return;
+
+			Record record;
+			record.name = name;
+			record.tokens = tokens;
+			record.options = options;
+			record.nsPerOp = measure(settings, opsPerCall, record.iterations, function);
+			records.push_back(std::move(record));
+		}
+
+		void print() const
+		{
+			if (settings.json) {
+				std::printf("{\n\t\"benchmarks\": [\n");
+				for (std::size_t idx = 0; idx < records.size(); ++idx) {
+					const Record& record = records[idx];
+					std::printf("\t\t{ \"name\": \"%s\", \"tokens\": %zu, \"options\": %zu, \"iterations\": %llu, "
+						"\"ns_per_op\": %.3f, \"ops_per_sec\": %.1f }%s\n",
+						record.name.c_str(), record.tokens, record.options,
+						static_cast<unsigned long long>(record.iterations), record.nsPerOp, 1e9 / record.nsPerOp,
+						(idx + 1 < records.size()) ? "," : "");
+				}
+				std::printf("\t]\n}\n");
+				return;
+			}
+
+			std::printf("name,tokens,options,iterations,ns_per_op,ops_per_sec\n");
+			for (const Record& record : records)
+				std::printf("%s,%zu,%zu,%llu,%.3f,%.1f\n", record.name.c_str(), record.tokens, record.options,
+					static_cast<unsigned long long>(record.iterations), record.nsPerOp, 1e9 / record.nsPerOp);
+		}
+	};
+
+	/**
+		@brief Parse throughput, ns_per_op is the time of one parse of the whole command line.
+	*/
+	void parseScaling(Runner& runner, const Settings& settings)
+	{
+		const std::vector<std::size_t> tokenCounts = settings.quick ?
+			std::vector<std::size_t>{ 10, 1000 } : std::vector<std::size_t>{ 10, 1000, 100000, 1000000 };
+		const std::vector<std::size_t> optionCounts = settings.quick ?
+			std::vector<std::size_t>{ 1, 50 } : std::vector<std::size_t>{ 1, 50, 5000 };
+
+		for (std::size_t options : optionCounts) {
+			ArgsManager manager;
+			std::vector<ArgId> ids;
+			registerOptions(manager, options, ids);
+
+			for (std::size_t tokens : tokenCounts) {
+				const CommandLine commandLine(tokens, options);
+
+				runner.run("parse", tokens, options, 1, [&]() {
+					manager.parse(commandLine.argc(), commandLine.argv(), 0);
+					sink = sink + manager.getResult().argPresent(ids[0]);
+				});
+
+				runner.run("parse_view", tokens, options, 1, [&]() {
+					manager.setContentMode(ContentMode::view);
+					manager.parse(commandLine.argc(), commandLine.argv(), 0);
+					manager.setContentMode(ContentMode::copy);
+					sink = sink + manager.getResult().argPresent(ids[0]);
+				});
+			}
+		}
+	}
+
+	/**
+		@brief Latency of the lookups of the parsed arguments, by id and by name.
+	*/
+	void lookupLatency(Runner& runner, const Settings& settings)
+	{
+		const std::vector<std::size_t> optionCounts = settings.quick ?
+			std::vector<std::size_t>{ 1, 50 } : std::vector<std::size_t>{ 1, 50, 5000 };
+
+		for (std::size_t options : optionCounts) {
+			ArgsManager manager;
+			std::vector<ArgId> ids;
+			registerOptions(manager, options, ids);
+
+			const CommandLine commandLine(options * 2, options);
+			manager.parse(commandLine.argc(), commandLine.argv(), 0);
+
+			std::vector<Argument> arguments;
+			for (std::size_t idx = 0; idx < options; ++idx)
+				arguments.emplace_back(true, optionName(idx));
+
+			runner.run("argValue_id", 0, options, options, [&]() {
+				for (ArgId id : ids)
+					sink = sink + manager.argValue(id).size();
+			});
+
+			runner.run("argPresent_id", 0, options, options, [&]() {
+				for (ArgId id : ids)
+					sink = sink + manager.argPresent(id);
+			});
+
+			runner.run("argValue_name", 0, options, options, [&]() {
+				for (const Argument& argument : arguments)
+					sink = sink + manager.argValue(argument).size();
+			});
+
+			runner.run("argPresent_name", 0, options, options, [&]() {
+				for (const Argument& argument : arguments)
+					sink = sink + manager.argPresent(argument);
+			});
+		}
+	}
+
+	/**
+		@brief Cost of one addRequired() while the count of registered options grows.
+	*/
+	void registrationCost(Runner& runner, const Settings& settings)
+	{
+		const std::vector<std::size_t> optionCounts = settings.quick ?
+			std::vector<std::size_t>{ 1, 50 } : std::vector<std::size_t>{ 1, 50, 5000 };
+
+		for (std::size_t options : optionCounts) {
+			std::vector<Argument> arguments;
+			for (std::size_t idx = 0; idx < options; ++idx)
+				arguments.emplace_back(true, optionName(idx), "-o" + std::to_string(idx));
+
+			runner.run("addRequired", 0, options, options, [&]() {
+				ArgsManager manager;
+				for (const Argument& argument : arguments)
+					manager.addRequired(argument);
+				sink = sink + manager.freeze()->size();
+			});
+		}
+	}
+
+	/**
+		@brief Classification of the tokens in bulk (TokenClassifier) and one by one, ns_per_op is per token.
+	*/
+	void tokenClassification(Runner& runner)
+	{
+		const std::string_view samples[] = {
+			"--output=result.txt", "-v", "input.txt", "--level", "-5", "--", "--include-directory=/usr/include"
+		};
+
+		// Batches of the size classified by the parse, the samples are mixed by a fixed pseudo-random sequence
+		constexpr std::size_t count = 64;
+		std::vector<std::string_view> tokens;
+		std::uint32_t random = 12345;
+		for (std::size_t idx = 0; idx < count; ++idx) {
+			random = random * 1103515245u + 12345u;
+			tokens.push_back(samples[(random >> 16) % (sizeof(samples) / sizeof(samples[0]))]);
+		}
+
+		std::vector<TokenKind> kinds(count);
+		std::vector<std::uint32_t> splits(count);
+
+		runner.run(std::string("classify_bulk_") + TokenClassifier::instructionSet(), count, 0, count, [&]() {
+			TokenClassifier::classify(tokens.data(), count, kinds.data(), splits.data());
+			sink = sink + static_cast<std::size_t>(kinds[count - 1]);
+		});
+
+		runner.run("classify_single", count, 0, count, [&]() {
+			for (std::size_t idx = 0; idx < count; ++idx)
+				kinds[idx] = TokenClassifier::classify(tokens[idx], splits[idx]);
+			sink = sink + static_cast<std::size_t>(kinds[count - 1]);
+		});
+	}
+
+	/**
+		@brief Lookup of the names in the plan, by the hash map of the names and by a generated NameTable.
+	*/
+	void nameLookup(Runner& runner, const Settings& settings)
+	{
+		const std::size_t options = settings.quick ? 50 : 4000;
+
+		std::vector<std::string> storage;
+		for (std::size_t idx = 0; idx < options; ++idx)
+			storage.push_back(optionName(idx));
+		const std::vector<std::string_view> names(storage.begin(), storage.end());
+
+		std::vector<std::int32_t> seeds;
+		std::vector<std::uint32_t> slotOf;
+		NameTable::generate(names, seeds, slotOf);
+
+		std::vector<NameTable::Slot> slots(names.size());
+		for (std::size_t idx = 0; idx < names.size(); ++idx)
+			slots[slotOf[idx]] = { names[idx], static_cast<ArgId>(idx) };
+
+		NameTable table;
+		table.seeds = seeds.data();
+		table.seedCount = static_cast<std::uint32_t>(seeds.size());
+		table.slots = slots.data();
+		table.slotCount = static_cast<std::uint32_t>(slots.size());
+		table.argumentCount = table.slotCount;
+
+		ArgsManager manager;
+		std::vector<ArgId> ids;
+		registerOptions(manager, options, ids);
+		const std::shared_ptr<const ParserPlan> indexed = manager.freeze();
+		const std::shared_ptr<const ParserPlan> generated = manager.setNameTable(&table).freeze();
+
+		runner.run("find_hash_map", 0, options, options, [&]() {
+			for (std::string_view name : names)
+				sink = sink + indexed->find(name);
+		});
+
+		runner.run("find_name_table", 0, options, options, [&]() {
+			for (std::string_view name : names)
+				sink = sink + generated->find(name);
+		});
+	}
+
+	void argumentEquality(Runner& runner)
+	{
+		const Argument argument(true, "--output", "-o");
+		const Argument same(true, "-o");
+		const Argument other(true, "--input", "-i");
+		const std::string name = "--output";
+
+		constexpr std::size_t batch = 1000;
+
+		runner.run("Argument_equal_hit", 0, 0, batch, [&]() {
+			for (std::size_t idx = 0; idx < batch; ++idx)
+				sink = sink + (argument == same);
+		});
+
+		runner.run("Argument_equal_miss", 0, 0, batch, [&]() {
+			for (std::size_t idx = 0; idx < batch; ++idx)
+				sink = sink + (argument == other);
+		});
+
+		runner.run("Argument_equal_string", 0, 0, batch, [&]() {
+			for (std::size_t idx = 0; idx < batch; ++idx)
+				sink = sink + (argument == name);
+		});
+	}
+
+	// Edit distance of the linear scan compared with the BK-tree of the plan
+	std::size_t editDistance(std::string_view left, std::string_view right)
+	{
+		std::vector<std::size_t> row(right.size() + 1);
+		for (std::size_t col = 0; col < row.size(); ++col)
+			row[col] = col;
+
+		for (std::size_t line = 1; line <= left.size(); ++line) {
+			std::size_t diagonal = row[0];
+			row[0] = line;
+			for (std::size_t col = 1; col <= right.size(); ++col) {
+				const std::size_t above = row[col];
+				row[col] = std::min({ above + 1, row[col - 1] + 1,
+					diagonal + ((left[line - 1] == right[col - 1]) ? 0 : 1) });
+				diagonal = above;
+			}
+		}
+
+		return row[right.size()];
+	}
+
+	/**
+		@brief Suggestions for a mistyped name: ParserPlan::suggest() (BK-tree) against a scan of all names.
+		The numbered names differ by few characters, the radius of 2 then reaches most of the tree;
+		the random names are spread and the tree visits a part of them.
+	*/
+	void suggestion(Runner& runner, const Settings& settings)
+	{
+		const std::vector<std::size_t> optionCounts = settings.quick ?
+			std::vector<std::size_t>{ 50 } : std::vector<std::size_t>{ 50, 5000 };
+
+		for (std::size_t options : optionCounts) {
+			for (const bool numbered : { true, false }) {
+				std::vector<std::string> names;
+				std::uint32_t random = 12345;
+				for (std::size_t idx = 0; idx < options; ++idx) {
+					if (numbered) {
+						names.push_back(optionName(idx));
+						continue;
+					}
+
+					random = random * 1103515245u + 12345u;
+					std::string name = "--";
+					for (std::size_t length = 6 + (random >> 16) % 9; name.size() < length + 2; ) {
+						random = random * 1103515245u + 12345u;
+						name += static_cast<char>('a' + (random >> 16) % 26);
+					}
+					names.push_back(std::move(name));
+				}
+
+				ArgsManager manager;
+				for (const std::string& name : names)
+					manager.addOptional(Argument(false, name));
+				const std::shared_ptr<const ParserPlan> plan = manager.freeze();
+
+				// One substituted character in the middle of a name
+				std::string token = names[options / 2];
+				token[token.size() / 2] = (token[token.size() / 2] == 'x') ? 'y' : 'x';
+
+				const std::string suffix = numbered ? "_numbered" : "_random";
+
+				runner.run("suggest_bk_tree" + suffix, 0, options, 1, [&]() {
+					sink = sink + plan->suggest(token).size();
+				});
+
+				runner.run("suggest_linear" + suffix, 0, options, 1, [&]() {
+					std::size_t near = 0;
+					for (const std::string& name : names)
+						near += editDistance(name, token) <= 2;
+					sink = sink + near;
+				});
+			}
+		}
+	}
+
+	bool parseSettings(int argc, char* argv[], Settings& settings)
+	{
+		for (int idx = 1; idx < argc; ++idx) {
+			const char* const param = argv[idx];
+
+			if (std::strcmp(param, "--quick") == 0)
+				settings.quick = true;
+			else if (std::strcmp(param, "--format=json") == 0)
+				settings.json = true;
+			else if (std::strcmp(param, "--format=csv") == 0)
+				settings.json = false;
+			else if (std::strncmp(param, "--filter=", 9) == 0)
+				settings.filter = param + 9;
+			else
+				return false;
+		}
+
+		return true;
+	}
+
+}
+
+int main(int argc, char* argv[])
+{
+	Settings settings;
+	if (!parseSettings(argc, argv, settings)) {
+		std::fprintf(stderr, "Usage: %s [--format=json|csv] [--filter=<substring>] [--quick]\n", argv[0]);
+		return 1;
+	}
+
+	Runner runner(settings);
+
+	try {
+		parseScaling(runner, settings);
+		lookupLatency(runner, settings);
+		registrationCost(runner, settings);
+		tokenClassification(runner);
+		nameLookup(runner, settings);
+		argumentEquality(runner);
+		suggestion(runner, settings);
+	}
+	catch (const std::exception& e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+
+	runner.print();
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include "ArgsManager.h"
+
+Command::Command(Definition definition, std::pmr::memory_resource* resource) :
+	definition(std::move(definition)), resource(resource)
+{
+	if (resource == nullptr)
+		throw std::invalid_argument("Pointer resource is NULL!");
+}
+
+Command::Command(std::string name, Definition definition, const Command& parent) :
+	name(std::move(name)), definition(std::move(definition)), parent(&parent), resource(parent.resource) {}
+
+Command& Command::add(std::string name, Definition definition)
+{
+	if (name.empty())
+		throw std::invalid_argument("Name of the command cannot be empty!");
+
+	if (childIndex.count(name) != 0)
+		throw std::runtime_error("This command has already been added");
+
+	children.push_back(std::make_unique<Command>(std::move(name), std::move(definition), *this));
+
+	// The key views the name owned by the child, which is never moved
+	Command& child = *children.back();
+	childIndex.emplace(child.name, &child);
+	return child;
+}
+
+const Command* Command::find(std::string_view name) const noexcept
+{
+	const auto found = childIndex.find(name);
+	return (found != childIndex.end()) ? found->second : nullptr;
+}
+
+const std::string& Command::getName() const noexcept
+{
+	return name;
+}
+
+std::string Command::path() const
+{
+	if (parent == nullptr)
+		return std::string();
+
+	std::string parentPath = parent->path();
+	return parentPath.empty() ? name : parentPath + " " + name;
+}
+
+const Command* Command::getParent() const noexcept
+{
+	return parent;
+}
+
+bool Command::built() const noexcept
+{
+	return planBuilt.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const ParserPlan> Command::plan() const
+{
+	// The plan is published by call_once to all threads calling plan()
+	std::call_once(planOnce, [this]() {
+		ArgsManager manager(resource);
+		if (definition)
+			definition(manager);
+
+		commandPlan = manager.freeze();
+		planBuilt.store(true, std::memory_order_release);
+	});
+
+	return commandPlan;
+}
+
+const Command& Command::dispatch(const unsigned int argc, const char* const argv[], unsigned int& beginIdx) const noexcept
+{
+	const Command* command = this;
+
+	while (argv != nullptr && beginIdx < argc && argv[beginIdx] != nullptr) {
+		const Command* const child = command->find(argv[beginIdx]);
+		if (child == nullptr)
+			break;
+
+		command = child;
+		++beginIdx;
+	}
+
+	return *command;
+}
+
+const Command& Command::parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+	ParseResult& result, ParseOptions options) const
+{
+	const Command& command = dispatch(argc, argv, beginIdx);
+	command.plan()->parse(argc, argv, beginIdx, result, options);
+	return command;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ParserPlan.h"
+#include "ParseResult.h"
+
+class ArgsManager;
+
+/**
+	@brief
+	Command with its own arguments and nested subcommands, git-style: "app remote add -f origin".
+	The leading tokens naming subcommands are dispatched through a hash index of the names of the children,
+	the remaining tokens are parsed against the plan of the chosen command only.
+	The arguments of a command are registered by its definition function on the first parse of that command,
+	so a tree of many commands costs only the index of the names until a command is used.
+	Commands are added before parsing; the tree can then be shared by any number of threads,
+	the plans are built once even if several threads dispatch to the same command.
+*/
+class Command
+{
+
+public:
+
+	/**
+		@brief Registers the arguments of a command, the other settings of the ArgsManager are not kept.
+	*/
+	using Definition = std::function<void(ArgsManager&)>;
+
+private:
+
+	std::string name;
+	Definition definition;
+	const Command* parent = nullptr;
+	std::pmr::memory_resource* resource;
+
+	std::vector<std::unique_ptr<Command>> children;
+	std::unordered_map<std::string_view, const Command*> childIndex;
+
+	// Plan built on the first use of the command
+	mutable std::once_flag planOnce;
+	mutable std::shared_ptr<const ParserPlan> commandPlan;
+	mutable std::atomic<bool> planBuilt{ false };
+
+public:
+
+	/**
+		@brief constructor of the root command.
+		@param definition registers the arguments of the root, used when no subcommand is passed; may be empty.
+		@param resource memory resource of the plans, must outlive the command and the plans.
+	*/
+	explicit Command(Definition definition = Definition(), std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	/**
+		@brief constructor of a subcommand, use add().
+		@param name name of the subcommand.
+		@param definition registers the arguments of the subcommand; may be empty.
+		@param parent parent command.
+	*/
+	Command(std::string name, Definition definition, const Command& parent);
+
+	Command(const Command&) = delete;
+	Command& operator=(const Command&) = delete;
+
+	/**
+		@brief Adds a subcommand, its arguments are not registered until it is used.
+		@return The subcommand, to add nested subcommands.
+		@throw If the name is empty or already added to this command.
+		@param name name of the subcommand, the token selecting it.
+		@param definition registers the arguments of the subcommand; may be empty.
+	*/
+	Command& add(std::string name, Definition definition = Definition());
+
+	/**
+		@brief Returns the subcommand with the specified name, nullptr if there is none.
+		@param name name of the subcommand.
+	*/
+	const Command* find(std::string_view name) const noexcept;
+
+	/**
+		@brief Returns the name of the command, empty for the root.
+	*/
+	const std::string& getName() const noexcept;
+
+	/**
+		@brief Returns the names of the command from the root separated by spaces, for example: "remote add".
+	*/
+	std::string path() const;
+
+	/**
+		@brief Returns the parent command, nullptr for the root.
+	*/
+	const Command* getParent() const noexcept;
+
+	/**
+		@brief Returns TRUE if the plan of the command was built, otherwise FALSE.
+	*/
+	bool built() const noexcept;
+
+	/**
+		@brief Returns the plan of the command, registering its arguments on the first call.
+		@throw If the definition throws, then the next call runs it again.
+	*/
+	std::shared_ptr<const ParserPlan> plan() const;
+
+	/**
+		@brief Selects the command named by the leading tokens, no plan is built.
+		@return The deepest command named by the tokens, this command if the first token is not a subcommand.
+		@param argc count of arguments.
+		@param argv arguments array.
+		@param beginIdx initial argument number, receives the index of the first argument of the selected command.
+	*/
+	const Command& dispatch(const unsigned int argc, const char* const argv[], unsigned int& beginIdx) const noexcept;
+
+	/**
+		@brief Selects the command named by the leading tokens and parses the other tokens against its plan.
+		@return The selected command.
+		@throw If the arguments are invalid (see ParserPlan::parse()) or the definition of the command throws.
+		@param argc count of arguments.
+		@param argv arguments array.
+		@param beginIdx initial argument number.
+		@param result receives the parsed arguments of the selected command.
+		@param options options of the parse.
+	*/
+	const Command& parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+		ParseResult& result, ParseOptions options = ParseOptions()) const;
+};
@@ -0,0 +1,115 @@
+#include "ArgsManager.h"
+
+namespace {
+
+	std::string_view trim(std::string_view text)
+	{
+		const std::size_t first = text.find_first_not_of(" \t\r");
+		if (first == std::string_view::npos)
+			return std::string_view();
+
+		const std::size_t last = text.find_last_not_of(" \t\r");
+		return text.substr(first, last - first + 1);
+	}
+
+	std::string_view unquote(std::string_view value)
+	{
+		if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front())
+			return value.substr(1, value.size() - 2);
+		return value;
+	}
+
+}
+
+void ConfigFile::index(std::string_view text)
+{
+	// UTF-8 byte order mark
+	if (text.size() >= 3 && text.compare(0, 3, "\xEF\xBB\xBF") == 0)
+		text.remove_prefix(3);
+
+	std::string_view section;
+	std::uint32_t line = 0;
+
+	for (std::size_t begin = 0; begin < text.size(); ++line) {
+		std::size_t end = text.find('\n', begin);
+		if (end == std::string_view::npos)
+			end = text.size();
+
+		const std::string_view content = trim(text.substr(begin, end - begin));
+		begin = end + 1;
+
+		if (content.empty() || content[0] == '#' || content[0] == ';')
+			continue;
+
+		if (content.front() == '[' && content.back() == ']') {
+			section = trim(content.substr(1, content.size() - 2));
+			continue;
+		}
+
+		Entry entry;
+		entry.line = line;
+
+		const std::size_t equals = content.find('=');
+		entry.key = trim(content.substr(0, equals));
+		if (equals != std::string_view::npos) {
+			entry.value = unquote(trim(content.substr(equals + 1)));
+			entry.hasValue = true;
+		}
+
+		if (entry.key.empty())
+			continue;
+
+		if (!section.empty()) {
+			std::string& key = sectionKeys.emplace_front(section);
+			key += '.';
+			key += entry.key;
+			entry.key = key;
+		}
+
+		settings.push_back(entry);
+	}
+}
+
+bool ConfigFile::open(const char* path)
+{
+	close();
+
+	if (!file.open(path))
+		return false;
+
+	filePath = path;
+	index(std::string_view(file.begin(), file.size()));
+	return true;
+}
+
+void ConfigFile::close() noexcept
+{
+	file.close();
+	filePath.clear();
+	settings.clear();
+	sectionKeys.clear();
+}
+
+const std::string& ConfigFile::path() const noexcept
+{
+	return filePath;
+}
+
+const std::vector<ConfigFile::Entry>& ConfigFile::entries() const noexcept
+{
+	return settings;
+}
+
+bool ConfigFile::nextValue(std::string_view& values, std::string_view& value) noexcept
+{
+	const std::size_t begin = values.find_first_not_of(" \t");
+	if (begin == std::string_view::npos) {
+		values = std::string_view();
+		return false;
+	}
+
+	const std::size_t end = values.find_first_of(" \t", begin);
+	value = values.substr(begin, end - begin);
+	values.remove_prefix((end == std::string_view::npos) ? values.size() : end);
+	return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <forward_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+/**
+	@brief
+	Configuration file in the INI or key=value format, mapped into memory and indexed once when it is opened.
+	Each line is "key = value" or a single key (an argument without content which is passed).
+	Lines starting with '#' or ';' are comments; a value enclosed in "double" or 'single' quotes is taken without them.
+	A key inside of a [section] is "section.key". The key names an argument without its leading dashes:
+	"output" or "server.port" sets --output or --server.port.
+	The keys and the values are views into the mapping, only the keys of a section are composed in storage of the file.
+	The object may be moved, the views stay valid until it is closed or destroyed.
+*/
+class ConfigFile
+{
+
+public:
+
+	/**
+		@brief Setting of the file.
+	*/
+	struct Entry {
+		std::string_view key;   ///< key, including the section.
+		std::string_view value; ///< value, empty if the line has no '='.
+		std::uint32_t line = 0; ///< index of the line, from 0.
+		bool hasValue = false;  ///< TRUE if the line has '='.
+	};
+
+private:
+
+	MappedFile file;
+	std::string filePath;
+	std::vector<Entry> settings;
+
+	// Keys composed with their section, the nodes of the list are never moved
+	std::forward_list<std::string> sectionKeys;
+
+	void index(std::string_view text);
+
+public:
+
+	ConfigFile() = default;
+	ConfigFile(ConfigFile&&) noexcept = default;
+	ConfigFile& operator=(ConfigFile&&) noexcept = default;
+	ConfigFile(const ConfigFile&) = delete;
+	ConfigFile& operator=(const ConfigFile&) = delete;
+
+	/**
+		@brief Maps and indexes the file, the previously opened file is closed.
+		@return TRUE if the file was read, FALSE if it cannot be opened or mapped.
+		@param path path of the file.
+	*/
+	bool open(const char* path);
+
+	/**
+		@brief Closes the file, the entries are cleared.
+	*/
+	void close() noexcept;
+
+	/**
+		@brief Returns the path the file was opened with, empty if no file is open.
+	*/
+	const std::string& path() const noexcept;
+
+	/**
+		@brief Returns the settings of the file in the order of the lines.
+	*/
+	const std::vector<Entry>& entries() const noexcept;
+
+	/**
+		@brief Extracts the next value of a setting with several values, separated by whitespace.
+		@return TRUE if a value was extracted, FALSE at the end of the setting.
+		@param values rest of the value of the setting, the extracted value is removed.
+		@param value receives the view of the extracted value.
+	*/
+	static bool nextValue(std::string_view& values, std::string_view& value) noexcept;
+};
@@ -0,0 +1,115 @@
+#include "ArgsManager.h"
+
+#include <cstring>
+
+IncrementalParser::IncrementalParser(std::shared_ptr<const ParserPlan> plan, std::pmr::memory_resource* resource,
+	const ParseOptions& options) :
+	plan(std::move(plan)), options(options), result(resource), partial(resource)
+{
+	if (!this->plan)
+		throw std::invalid_argument("Pointer plan is NULL!");
+
+	// The values are stored by the matcher, no copy is needed
+	this->options.content = ContentMode::view;
+	this->options.responseFiles = false;
+
+	reset();
+}
+
+void IncrementalParser::checkActive() const
+{
+	if (finished)
+		throw std::runtime_error("Parsing is finished, reset() must be called first.");
+}
+
+ParseError IncrementalParser::match(std::string_view token)
+{
+	if (!failure)
+		failure = matcher->token(token, tokenCount);
+
+	++tokenCount;
+	return failure;
+}
+
+ParseError IncrementalParser::feed(std::string_view token)
+{
+	checkActive();
+	return match(token);
+}
+
+ParseError IncrementalParser::feedBytes(const char* data, std::size_t size)
+{
+	checkActive();
+
+	if (data == nullptr && size > 0)
+		throw std::invalid_argument("Pointer data is NULL!");
+
+	const char* const end = data + size;
+	while (data != end) {
+		const char* const terminator = static_cast<const char*>(std::memchr(data, '\0', static_cast<std::size_t>(end - data)));
+		if (terminator == nullptr) {
+			partial.append(data, end);
+			break;
+		}
+
+		// Tokens inside of the chunk are matched without a copy
+		if (partial.empty()) {
+			match(std::string_view(data, static_cast<std::size_t>(terminator - data)));
+		}
+		else {
+			partial.append(data, terminator);
+			match(partial);
+			partial.clear();
+		}
+
+		data = terminator + 1;
+	}
+
+	return failure;
+}
+
+ParseError IncrementalParser::finish()
+{
+	checkActive();
+
+	if (!partial.empty()) {
+		match(partial);
+		partial.clear();
+	}
+
+	finished = true;
+
+	if (!failure)
+		failure = matcher->finish(options);
+
+	plan->recordStats(result, failure);
+
+	if (failure)
+		result.reset();
+
+	return failure;
+}
+
+void IncrementalParser::reset()
+{
+	matcher.emplace(*plan, result, true, options.strict, options.optionsTerminator);
+	partial.clear();
+	tokenCount = 0;
+	failure = ParseError();
+	finished = false;
+}
+
+std::uint32_t IncrementalParser::tokens() const noexcept
+{
+	return tokenCount;
+}
+
+const ParseResult& IncrementalParser::getResult() const noexcept
+{
+	return result;
+}
+
+const ParserPlan& IncrementalParser::getPlan() const noexcept
+{
+	return *plan;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "ParserPlan.h"
+#include "ParseResult.h"
+#include "ParseError.h"
+#include "Matcher.h"
+
+/**
+	@brief
+	Push-style parser for arguments received piece by piece, for example over a pipe.
+	The tokens are matched as soon as they are fed and only the content of the matched arguments is copied,
+	so the whole command line is never buffered. finish() runs the checks of the required arguments.
+*/
+class IncrementalParser
+{
+
+private:
+
+	std::shared_ptr<const ParserPlan> plan;
+	ParseOptions options;
+	ParseResult result;
+	std::optional<Matcher> matcher;
+
+	// Token split by the boundary of byte chunks
+	std::pmr::string partial;
+
+	std::uint32_t tokenCount = 0;
+	ParseError failure;
+	bool finished = false;
+
+	void checkActive() const;
+	ParseError match(std::string_view token);
+
+public:
+
+	/**
+		@brief constructor.
+		@throw If plan is NULL.
+		@param plan plan of the parse.
+		@param resource memory resource of the result and the buffered tokens, must outlive the parser.
+		@param options options of the parse, the content is always copied and response files are not expanded.
+	*/
+	explicit IncrementalParser(std::shared_ptr<const ParserPlan> plan,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource(), const ParseOptions& options = ParseOptions());
+
+	IncrementalParser(const IncrementalParser&) = delete;
+	IncrementalParser& operator=(const IncrementalParser&) = delete;
+
+	/**
+		@brief Matches the next token, the token does not need to outlive the call.
+		@return The first error of the parse, ParseErrc::none if all tokens so far are valid.
+		Once an error is returned, the following tokens are ignored.
+		@throw If the parse was finished.
+		@param token next token.
+	*/
+	ParseError feed(std::string_view token);
+
+	/**
+		@brief Matches the tokens of a chunk of bytes, where each token is terminated by a NUL byte.
+		The last token of the chunk may continue in the next chunk; the chunk does not need to outlive the call.
+		@return The first error of the parse, ParseErrc::none if all tokens so far are valid.
+		@throw If the parse was finished.
+		@param data bytes of the chunk.
+		@param size count of bytes.
+	*/
+	ParseError feedBytes(const char* data, std::size_t size);
+
+	/**
+		@brief Ends the parse: the unterminated last token of the byte chunks is matched,
+		then the content of the pending argument, the required arguments and the required set are checked.
+		@return The first error of the parse, ParseErrc::none if the arguments are valid.
+		@throw If the parse was finished.
+	*/
+	ParseError finish();
+
+	/**
+		@brief Starts a new parse, the memory of the result is reused.
+	*/
+	void reset();
+
+	/**
+		@brief Returns the count of tokens fed so far.
+	*/
+	std::uint32_t tokens() const noexcept;
+
+	/**
+		@brief Returns the result, parsed only after finish() returned no error.
+	*/
+	const ParseResult& getResult() const noexcept;
+
+	/**
+		@brief Returns the plan of the parser.
+	*/
+	const ParserPlan& getPlan() const noexcept;
+};
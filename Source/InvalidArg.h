@@ -1,18 +1,29 @@
 #pragma once
 
 #include <exception>
+#include <string>
 
 /**
 	@brief Exception class.
 */
 class InvalidArg: public std::exception
 {
-	
+
+private:
+
+	// The message is stored by the exception, std::exception(const char*) exists only on MSVC
+	std::string message;
+
 public:
 
 	/**
 		@brief constructor.
 	*/
-	InvalidArg(const std::string& errorMsg) : std::exception(errorMsg.c_str()) {};
+	InvalidArg(const std::string& errorMsg) : message(errorMsg) {};
 	virtual ~InvalidArg() {};
-};
\ No newline at end of file
+
+	/**
+		@brief Returns the message of the error.
+	*/
+	const char* what() const noexcept override { return message.c_str(); }
+};
@@ -0,0 +1,549 @@
+#include "ArgsManager.h"
+
+#include <functional>
+
+LazyResult::LazyResult() :
+	LazyResult(std::pmr::get_default_resource()) {}
+
+LazyResult::LazyResult(std::pmr::memory_resource* resource) :
+	eager(resource), firstTokens(resource), nextTokens(resource), contentCounts(resource), configBegin(resource), configEntries(resource),
+	environmentValues(resource), states(resource), occurrences(resource), sources(resource), values(resource), typedValues(resource) {}
+
+void LazyResult::checkParsed() const
+{
+	if (!plan)
+		throw std::runtime_error("Parsing failed");
+
+	match();
+	if (walkError)
+		plan->throwError(walkError, options);
+}
+
+void LazyResult::checkId(ArgId id) const
+{
+	checkParsed();
+
+	if (id >= plan->size())
+		throw std::out_of_range("Argument handle out of range.");
+}
+
+bool LazyResult::matchTokens(ParseError& error) const
+{
+	const ParserPlan& plan = *this->plan;
+	const std::uint32_t count = static_cast<std::uint32_t>(plan.size());
+
+	firstTokens.assign(count, ParseError::noToken);
+	nextTokens.assign(argc, ParseError::noToken);
+	contentCounts.assign(argc, 0);
+	occurrences.assign(count, 0);
+	std::pmr::vector<std::uint32_t> lastTokens(count, ParseError::noToken, firstTokens.get_allocator());
+
+	// States of the matcher: the argument waiting for its content and the content tokens it requires and may take
+	ArgId pending = ParserPlan::npos;
+	std::uint32_t pendingToken = 0;
+	std::uint32_t required = 0;
+	std::uint32_t optional = 0;
+	bool ended = false;
+
+	for (unsigned int idx = beginIdx; idx < argc; ++idx) {
+		if (argv[idx] == nullptr) {
+			if (pending != ParserPlan::npos && required != 0)
+				error = { ParseErrc::missingContent, pendingToken, pending };
+			else
+				error = { ParseErrc::nullArgument, idx };
+			return true;
+		}
+
+		const std::string_view token(argv[idx]);
+
+		// The tokens following "--" are operands, even if they start with '-'
+		if (ended)
+			continue;
+
+		// Response files are expanded by the matcher
+		if (options.responseFiles && token.size() > 1 && token[0] == '@')
+			return false;
+
+		std::uint32_t split;
+		const TokenKind kind = TokenClassifier::classify(token, split);
+
+		if (pending != ParserPlan::npos) {
+			if (plan.takesContent(pending, token, kind)) {
+				++contentCounts[pendingToken];
+
+				if (required != 0)
+					--required;
+				else if (optional != Argument::variadic)
+					--optional;
+
+				if (required == 0 && optional == 0)
+					pending = ParserPlan::npos;
+				continue;
+			}
+
+			if (required != 0) {
+				error = { ParseErrc::missingContent, pendingToken, pending };
+				return true;
+			}
+			pending = ParserPlan::npos;
+		}
+
+		if (kind == TokenKind::terminator && options.optionsTerminator) {
+			ended = true;
+			continue;
+		}
+
+		const ArgId id = plan.find(token);
+		if (id == ParserPlan::npos) {
+			// --name=value, -ofile and bundles are split by the matcher
+			if (kind == TokenKind::longOptionValue && plan.find(token.substr(0, split)) != ParserPlan::npos)
+				return false;
+
+			if (kind == TokenKind::shortOption && token.size() > 2) {
+				const char name[2] = { '-', token[1] };
+				if (plan.find(std::string_view(name, 2)) != ParserPlan::npos)
+					return false;
+			}
+			continue;
+		}
+
+		if (lastTokens[id] == ParseError::noToken)
+			firstTokens[id] = idx;
+		else
+			nextTokens[lastTokens[id]] = idx;
+		lastTokens[id] = idx;
+
+		// Content of a repeated argument which is not repeatable is skipped
+		const bool collect = occurrences[id]++ == 0 || (plan.argumentFlags(id) & ParserPlan::repeatable);
+		const std::uint32_t arity = plan.argumentArity(id);
+		if (arity == 0)
+			continue;
+
+		pending = id;
+		pendingToken = idx;
+
+		if (!collect) {
+			required = 0;
+			optional = arity;
+		}
+		else if (arity == Argument::variadic) {
+			required = 1;
+			optional = Argument::variadic;
+		}
+		else {
+			required = arity;
+			optional = 0;
+		}
+	}
+
+	if (pending != ParserPlan::npos && required != 0)
+		error = { ParseErrc::missingContent, pendingToken, pending };
+
+	return true;
+}
+
+bool LazyResult::walkTokens() const
+{
+	ParseError error;
+	if (!matchTokens(error))
+		return false;
+
+	const std::uint32_t count = static_cast<std::uint32_t>(plan->size());
+	states.assign(count, unresolved);
+	sources.assign(count, ValueSource::none);
+	values.resize(count);
+	typedValues.resize(count);
+
+	walkError = error;
+	walk = Walk::matched;
+	return true;
+}
+
+void LazyResult::match() const
+{
+	if (walk != Walk::pending)
+		return;
+
+	// The matcher parses what the walk declines, the content views argv as the walk does
+	if (!walkTokens()) {
+		walkError = plan->tryParse(argc, argv, beginIdx, eager, options);
+		walk = Walk::declined;
+	}
+}
+
+void LazyResult::indexSources() const
+{
+	if (sourcesIndexed)
+		return;
+
+	const std::uint32_t count = static_cast<std::uint32_t>(plan->size());
+
+	// The last file setting an argument decides it, each setting of the argument in that file is read
+	std::pmr::vector<std::uint32_t> decidingFiles(count, ParseError::noToken, configBegin.get_allocator());
+	std::pmr::vector<ArgId> entryIds(configBegin.get_allocator());
+
+	for (std::size_t file = options.configCount; file-- != 0;) {
+		for (const ConfigFile::Entry& entry : options.configFiles[file].entries()) {
+			const ArgId id = plan->findConfigKey(entry.key);
+			if (id != ParserPlan::npos && decidingFiles[id] == ParseError::noToken)
+				decidingFiles[id] = static_cast<std::uint32_t>(file);
+		}
+	}
+
+	configBegin.assign(count + 1, 0);
+	for (std::size_t file = 0; file < options.configCount; ++file) {
+		for (const ConfigFile::Entry& entry : options.configFiles[file].entries()) {
+			const ArgId id = plan->findConfigKey(entry.key);
+			const bool deciding = id != ParserPlan::npos && decidingFiles[id] == file;
+			entryIds.push_back(deciding ? id : ParserPlan::npos);
+			if (deciding)
+				++configBegin[id + 1];
+		}
+	}
+
+	for (std::uint32_t id = 0; id < count; ++id)
+		configBegin[id + 1] += configBegin[id];
+
+	// The settings are grouped by argument in the order of the lines
+	std::pmr::vector<std::uint32_t> next(configBegin.begin(), configBegin.end() - 1, configBegin.get_allocator());
+	configEntries.assign(configBegin[count], nullptr);
+	std::size_t entryIdx = 0;
+	for (std::size_t file = 0; file < options.configCount; ++file) {
+		for (const ConfigFile::Entry& entry : options.configFiles[file].entries()) {
+			const ArgId id = entryIds[entryIdx++];
+			if (id != ParserPlan::npos)
+				configEntries[next[id]++] = &entry;
+		}
+	}
+
+	// The environment is scanned once, a variable repeated in the block is read at its first entry
+	environmentValues.assign(count, nullptr);
+	std::uint32_t unseen = plan->environmentCount();
+	const char* const* entries = (options.environment != nullptr) ? options.environment : ParserPlan::processEnvironment();
+
+	for (; unseen != 0 && entries != nullptr && *entries != nullptr; ++entries) {
+		const std::string_view entry(*entries);
+
+		// Names of the hidden variables of Windows start with '='
+		const std::size_t equals = entry.find('=', 1);
+		if (equals == std::string_view::npos)
+			continue;
+
+		const ArgId id = plan->findEnvironment(entry.substr(0, equals));
+		if (id == ParserPlan::npos || environmentValues[id] != nullptr)
+			continue;
+
+		environmentValues[id] = *entries + equals + 1;
+		--unseen;
+	}
+
+	sourcesIndexed = true;
+}
+
+void LazyResult::throwSetting(ArgId id, const ConfigFile::Entry& entry) const
+{
+	ParseError invalid{ ParseErrc::invalidConfigValue, entry.line, id };
+
+	// The entry is one of the entries of its file, std::less orders the pointers into distinct vectors
+	const std::less<const ConfigFile::Entry*> before;
+	for (std::size_t file = 0; file < options.configCount; ++file) {
+		const auto& entries = options.configFiles[file].entries();
+		if (!before(&entry, entries.data()) && before(&entry, entries.data() + entries.size()))
+			invalid.configFile = static_cast<std::uint32_t>(file);
+	}
+
+	plan->throwError(invalid, options);
+}
+
+void LazyResult::resolve(ArgId id) const
+{
+	if (states[id] == resolved)
+		return;
+
+	const Argument& arg = plan->argument(id);
+	const std::uint32_t arity = plan->argumentArity(id);
+	const ValueType type = plan->argumentType(id);
+	const bool repeatable = (plan->argumentFlags(id) & ParserPlan::repeatable) != 0;
+
+	std::uint32_t found = occurrences[id];
+	ValueSource source = (found != 0) ? ValueSource::commandLine : ValueSource::none;
+	std::pmr::vector<Content> argValues(values.get_allocator());
+	std::pmr::vector<TypedValue> argTypedValues(typedValues.get_allocator());
+
+	// Returns FALSE if the value is not valid
+	const auto add = [&](std::string_view value) {
+		TypedValue typed;
+		if (type != ValueType::string && !convertValue(type, arg.getChoices(), value, typed))
+			return false;
+
+		argValues.emplace_back(value);
+		if (type != ValueType::string)
+			argTypedValues.push_back(typed);
+		return true;
+	};
+
+	// The content of the first occurrence is kept, unless the argument is repeatable
+	for (std::uint32_t token = firstTokens[id]; token != ParseError::noToken; token = nextTokens[token]) {
+		for (std::uint32_t idx = token + 1; idx <= token + contentCounts[token]; ++idx) {
+			if (!add(argv[idx]))
+				plan->throwError({ ParseErrc::invalidValue, idx, id });
+		}
+
+		if (!repeatable)
+			break;
+	}
+
+	if (found == 0 && (options.configCount != 0 || !arg.getEnv().empty()))
+		indexSources();
+
+	// The settings decide the argument missing from the command line, even if they set a flag to false
+	const std::uint32_t firstSetting = (found == 0 && options.configCount != 0) ? configBegin[id] : 0;
+	const std::uint32_t lastSetting = (found == 0 && options.configCount != 0) ? configBegin[id + 1] : 0;
+	const bool decided = found != 0 || firstSetting != lastSetting;
+
+	for (std::uint32_t setting = firstSetting; setting < lastSetting; ++setting) {
+		const ConfigFile::Entry& entry = *configEntries[setting];
+		// A key without value passes the argument without content
+		if (arity == 0) {
+			TypedValue typed;
+			if (entry.hasValue && !convertValue(ValueType::boolean, arg.getChoices(), entry.value, typed))
+				throwSetting(id, entry);
+
+			if (!entry.hasValue || typed.integer != 0) {
+				++found;
+				source = ValueSource::configFile;
+			}
+			continue;
+		}
+
+		if (!entry.hasValue)
+			throwSetting(id, entry);
+
+		const bool collect = found++ == 0 || repeatable;
+		source = ValueSource::configFile;
+
+		// The values of an argument with arity are separated by whitespace, a single value is taken as a whole
+		std::string_view rest = entry.value;
+		std::string_view value = entry.value;
+		std::uint32_t valueCount = 0;
+		while ((arity == 1) ? valueCount == 0 : ConfigFile::nextValue(rest, value)) {
+			++valueCount;
+
+			TypedValue typed;
+			if (type != ValueType::string && !convertValue(type, arg.getChoices(), value, typed))
+				throwSetting(id, entry);
+
+			if (collect) {
+				argValues.emplace_back(value);
+				if (type != ValueType::string)
+					argTypedValues.push_back(typed);
+			}
+		}
+
+		if (valueCount == 0 || (arity != Argument::variadic && valueCount != arity))
+			throwSetting(id, entry);
+	}
+
+	const char* const variable = (!decided && !arg.getEnv().empty()) ? environmentValues[id] : nullptr;
+
+	if (variable != nullptr) {
+		const std::string_view value(variable);
+		const ValueType variableType = (arity == 0) ? ValueType::boolean : type;
+
+		TypedValue typed;
+		if (variableType != ValueType::string && !convertValue(variableType, arg.getChoices(), value, typed))
+			plan->throwError({ ParseErrc::invalidEnvironment, ParseError::noToken, id });
+
+		if (arity != 0) {
+			argValues.emplace_back(value);
+			if (type != ValueType::string)
+				argTypedValues.push_back(typed);
+		}
+
+		if (arity != 0 || typed.integer != 0) {
+			found = 1;
+			source = ValueSource::environment;
+		}
+	}
+
+	occurrences[id] = found;
+	sources[id] = source;
+	values[id] = std::move(argValues);
+	typedValues[id] = std::move(argTypedValues);
+	states[id] = resolved;
+}
+
+bool LazyResult::parse(std::shared_ptr<const ParserPlan> plan, const unsigned int argc, const char* const argv[],
+	unsigned int beginIdx, const ParseOptions& options)
+{
+	reset();
+
+	if (!plan)
+		throw std::invalid_argument("Pointer plan is NULL!");
+
+	// Unknown options and abbreviations are reported by the matcher
+	if (options.strict)
+		return false;
+
+	if (argc == 0 && (plan->requiresArgs() || plan->requiresSet()))
+		plan->throwError({ ParseErrc::noArguments });
+
+	if (argc > 0 && argv == nullptr)
+		plan->throwError({ ParseErrc::nullArgv });
+
+	if (beginIdx > argc)
+		plan->throwError({ ParseErrc::beginOutOfRange });
+
+	this->plan = std::move(plan);
+	this->argv = argv;
+	this->argc = argc;
+	this->beginIdx = beginIdx;
+	this->options = options;
+	this->options.content = ContentMode::view;
+
+	// The walk is deferred to the first access, unless the required arguments are checked by the parse
+	if (!this->plan->requiresArgs() && !this->plan->requiresSet())
+		return true;
+
+	try {
+		if (!walkTokens()) {
+			reset();
+			return false;
+		}
+
+		if (walkError)
+			this->plan->throwError(walkError, this->options);
+
+		const std::uint32_t count = static_cast<std::uint32_t>(this->plan->size());
+
+		// Only the required arguments are resolved upfront
+		for (ArgId id = 0; id < count; ++id) {
+			if ((this->plan->argumentFlags(id) & ParserPlan::required) && !argPresent(id))
+				this->plan->throwError({ ParseErrc::missingRequired, ParseError::noToken, id });
+		}
+
+		bool setFound = !this->plan->requiresSet();
+		for (ArgId id = 0; id < count && !setFound; ++id)
+			setFound = (this->plan->argumentFlags(id) & ParserPlan::requiredSet) && argPresent(id);
+
+		if (!setFound)
+			this->plan->throwError({ ParseErrc::missingRequiredFromSet });
+	}
+	catch (...) {
+		reset();
+		throw;
+	}
+
+	return true;
+}
+
+void LazyResult::reset() noexcept
+{
+	plan.reset();
+	argv = nullptr;
+	argc = 0;
+	beginIdx = 0;
+	options = ParseOptions();
+	walk = Walk::pending;
+	walkError = ParseError();
+	eager.reset();
+	sourcesIndexed = false;
+
+	firstTokens.clear();
+	nextTokens.clear();
+	contentCounts.clear();
+	configBegin.clear();
+	configEntries.clear();
+	environmentValues.clear();
+	states.clear();
+	occurrences.clear();
+	sources.clear();
+	values.clear();
+	typedValues.clear();
+}
+
+bool LazyResult::parsed() const noexcept
+{
+	return plan != nullptr;
+}
+
+ArgId LazyResult::indexOf(const Argument& arg) const noexcept
+{
+	return plan ? plan->indexOf(arg) : ParserPlan::npos;
+}
+
+Content LazyResult::argValue(ArgId id) const
+{
+	checkId(id);
+	if (walk == Walk::declined)
+		return eager.argValue(id);
+
+	if (!argPresent(id))
+		throw InvalidArg("Parameter " + plan->argument(id).quotedNames() + " not found!");
+
+	if (!(plan->argumentFlags(id) & ParserPlan::hasContent))
+		throw std::runtime_error("Parameter " + plan->argument(id).quotedNames() + " has no content!");
+
+	return values[id].front();
+}
+
+ValueRange LazyResult::argValues(ArgId id) const
+{
+	checkId(id);
+	if (walk == Walk::declined)
+		return eager.argValues(id);
+
+	const bool present = argPresent(id);
+
+	if (!(plan->argumentFlags(id) & ParserPlan::hasContent))
+		throw std::runtime_error("Parameter " + plan->argument(id).quotedNames() + " has no content!");
+
+	if (!present)
+		return ValueRange();
+
+	const std::pmr::vector<Content>& argValues = values[id];
+	return ValueRange(argValues.data(), argValues.data() + argValues.size());
+}
+
+const TypedValue& LazyResult::typedValue(ArgId id, std::size_t idx, ValueType type) const
+{
+	checkId(id);
+	if (walk == Walk::declined)
+		return eager.typedValue(id, idx, type);
+
+	if (!argPresent(id))
+		throw InvalidArg("Parameter " + plan->argument(id).quotedNames() + " not found!");
+
+	if (plan->argumentType(id) != type)
+		throw std::runtime_error("Parameter " + plan->argument(id).quotedNames() + " has content of another type!");
+
+	if (idx >= typedValues[id].size())
+		throw std::out_of_range("Value index out of range.");
+
+	return typedValues[id][idx];
+}
+
+bool LazyResult::argPresent(ArgId id) const
+{
+	return argOccurrences(id) != 0;
+}
+
+std::uint32_t LazyResult::argOccurrences(ArgId id) const
+{
+	checkId(id);
+	if (walk == Walk::declined)
+		return eager.argOccurrences(id);
+
+	resolve(id);
+	return occurrences[id];
+}
+
+ValueSource LazyResult::argSource(ArgId id) const
+{
+	checkId(id);
+	if (walk == Walk::declined)
+		return eager.argSource(id);
+
+	resolve(id);
+	return sources[id];
+}
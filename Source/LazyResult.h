@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "Argument.h"
+#include "ParserPlan.h"
+#include "ParseResult.h"
+#include "ConfigFile.h"
+
+/**
+	@brief
+	Result of a lazy parse. The tokens are walked once with the rules of the matcher (see Matcher):
+	the names are found through the index of the plan, the content is taken by ParserPlan::takesContent()
+	and "--" ends the options with ParseOptions::optionsTerminator.
+	The walk is deferred to the first access, so a parse which is never read costs no token scan;
+	the missing content and the NULL tokens are then reported on every access.
+	Only a plan with required arguments or a required set is walked by the parse, which reports the errors of the tokens
+	and the missing required arguments as ParserPlan::parse() does.
+	The content of an argument is converted on the first access and the outcome is memoized,
+	so the arguments which are never read cost no conversion; an invalid value is reported on access.
+	The content always points into argv, which must outlive the result.
+	An argument which is not passed is read from the configuration files, then from its environment variable
+	(see ParseOptions) when it is resolved; the value then points into the mapped file or the environment.
+	The settings of the files and the environment are indexed once, on the first access to an argument which is not passed.
+	What only the matcher handles is declined: strict parses, response files, --name=value, -ofile and bundles.
+	The parse then returns FALSE, or a deferred walk lets the matcher parse the tokens on the first access.
+	The memoization modifies the result, so it must not be accessed from several threads at the same time.
+*/
+class LazyResult
+{
+
+private:
+
+	std::shared_ptr<const ParserPlan> plan;
+
+	const char* const* argv = nullptr;
+	unsigned int argc = 0;
+	unsigned int beginIdx = 0;
+	ParseOptions options;
+
+	enum State : std::uint8_t {
+		unresolved = 0,
+		resolved
+	};
+
+	enum class Walk : std::uint8_t {
+		pending = 0,
+		matched,
+		declined
+	};
+
+	// Outcome of the walk, its error is reported on every access
+	mutable Walk walk = Walk::pending;
+	mutable ParseError walkError;
+
+	// Parse of the matcher when the deferred walk is declined
+	mutable ParseResult eager;
+
+	// Tokens naming each argument: the first one, then the next token naming the same argument.
+	// The content of a token are the contentCounts[idx] tokens following it
+	mutable std::pmr::vector<std::uint32_t> firstTokens;
+	mutable std::pmr::vector<std::uint32_t> nextTokens;
+	mutable std::pmr::vector<std::uint32_t> contentCounts;
+
+	// Settings deciding each argument, [configBegin[id], configBegin[id + 1]) of configEntries, and values of the environment
+	mutable bool sourcesIndexed = false;
+	mutable std::pmr::vector<std::uint32_t> configBegin;
+	mutable std::pmr::vector<const ConfigFile::Entry*> configEntries;
+	mutable std::pmr::vector<const char*> environmentValues;
+
+	// Memoized matches, the occurrences of the command line are counted by the parse
+	// and the values are stored only for the resolved arguments
+	mutable std::pmr::vector<std::uint8_t> states;
+	mutable std::pmr::vector<std::uint32_t> occurrences;
+	mutable std::pmr::vector<ValueSource> sources;
+	mutable std::pmr::vector<std::pmr::vector<Content>> values;
+	mutable std::pmr::vector<std::pmr::vector<TypedValue>> typedValues;
+
+	void checkParsed() const;
+	void checkId(ArgId id) const;
+	bool matchTokens(ParseError& error) const;
+	bool walkTokens() const;
+	void match() const;
+	void indexSources() const;
+	void resolve(ArgId id) const;
+
+	// Throws ParseErrc::invalidConfigValue naming the file of the entry
+	[[noreturn]] void throwSetting(ArgId id, const ConfigFile::Entry& entry) const;
+
+public:
+
+	/**
+		@brief constructor, the storage is allocated from the default memory resource.
+	*/
+	LazyResult();
+
+	/**
+		@brief constructor.
+		@param resource memory resource of the memoized matches, must outlive the result.
+	*/
+	explicit LazyResult(std::pmr::memory_resource* resource);
+
+	/**
+		@brief Keeps the tokens for the first access, or matches them and checks the required arguments if the plan has any.
+		@return TRUE if the arguments were parsed, FALSE if the parse needs the matcher (see ParserPlan::parse()), the result is then unparsed.
+		@throw If plan is NULL, with the exceptions of ParserPlan::parse() for invalid parameters
+		and, when the tokens are matched, for their errors and the missing required arguments.
+		@param plan plan of the parse.
+		@param argc count of arguments.
+		@param argv arguments array.
+		@param beginIdx initial argument number.
+		@param options environment and configuration files read by the arguments which are not passed,
+		they must outlive the result. The content mode is ignored.
+	*/
+	bool parse(std::shared_ptr<const ParserPlan> plan, const unsigned int argc, const char* const argv[],
+		unsigned int beginIdx, const ParseOptions& options = ParseOptions());
+
+	/**
+		@brief Clears the result, it becomes unparsed.
+	*/
+	void reset() noexcept;
+
+	/**
+		@brief Returns TRUE if the result was filled by a parse, otherwise FALSE.
+	*/
+	bool parsed() const noexcept;
+
+	/**
+		@brief Returns the handle of the argument matching at least one name of arg.
+		@return Handle of the argument or ParserPlan::npos if it is not registered.
+		@param arg argument.
+	*/
+	ArgId indexOf(const Argument& arg) const noexcept;
+
+	/**
+		@brief Extract content of the argument with the specified handle, resolved on the first access.
+		@return View of the content into argv.
+		@throw id is out of range, argument or its content not found, has no content, invalid value or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	Content argValue(ArgId id) const;
+
+	/**
+		@brief Returns all content values of the argument with the specified handle, resolved on the first access.
+		@return Range of the values, empty if the argument is not present.
+		@throw id is out of range, content not found, has no content, invalid value or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	ValueRange argValues(ArgId id) const;
+
+	/**
+		@brief Returns the value of the typed argument with the specified handle, resolved on the first access.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or the result was not parsed.
+		@param id handle of the argument.
+		@param idx index of the value in argValues().
+		@param type expected type of the argument.
+	*/
+	const TypedValue& typedValue(ArgId id, std::size_t idx, ValueType type) const;
+
+	/**
+		@brief Checks if the argument with the specified handle is present, resolved on the first access.
+		@return True if arguemnt is present in the passed arguments, otherwise false.
+		@throw id is out of range, content not found, invalid value or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	bool argPresent(ArgId id) const;
+
+	/**
+		@brief Returns how many times the argument with the specified handle is present, resolved on the first access.
+		@throw id is out of range, content not found, invalid value or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	std::uint32_t argOccurrences(ArgId id) const;
+
+	/**
+		@brief Returns the source of the argument with the specified handle, resolved on the first access.
+		@throw id is out of range, content not found, invalid value or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	ValueSource argSource(ArgId id) const;
+};
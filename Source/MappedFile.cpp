@@ -0,0 +1,131 @@
+#include "ArgsManager.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+	data(std::exchange(other.data, nullptr)), length(std::exchange(other.length, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other) {
+		unmap();
+		data = std::exchange(other.data, nullptr);
+		length = std::exchange(other.length, 0);
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+void MappedFile::unmap() noexcept
+{
+	if (data != nullptr) {
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+#else
+		munmap(data, length);
+#endif
+	}
+	data = nullptr;
+	length = 0;
+}
+
+bool MappedFile::open(const char* path) noexcept
+{
+	unmap();
+
+	if (path == nullptr)
+		return false;
+
+#ifdef _WIN32
+	const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+
+	// Empty file cannot be mapped, it has no tokens anyway
+	if (fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return true;
+	}
+
+	const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		return false;
+
+	// The view keeps the mapping alive
+	void* const view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (view == nullptr)
+		return false;
+
+	data = static_cast<char*>(view);
+	length = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+	const int file = ::open(path, O_RDONLY | O_CLOEXEC);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || !S_ISREG(info.st_mode)) {
+		::close(file);
+		return false;
+	}
+
+	// Empty file cannot be mapped, it has no tokens anyway
+	if (info.st_size == 0) {
+		::close(file);
+		return true;
+	}
+
+	const std::size_t fileSize = static_cast<std::size_t>(info.st_size);
+	void* const view = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (view == MAP_FAILED)
+		return false;
+
+	madvise(view, fileSize, MADV_SEQUENTIAL);
+
+	data = static_cast<char*>(view);
+	length = fileSize;
+#endif
+
+	return true;
+}
+
+void MappedFile::close() noexcept
+{
+	unmap();
+}
+
+char* MappedFile::begin() const noexcept
+{
+	return data;
+}
+
+std::size_t MappedFile::size() const noexcept
+{
+	return length;
+}
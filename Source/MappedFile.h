@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+	@brief
+	File mapped into memory as a private copy-on-write view:
+	the mapped bytes can be modified in place (for example by Tokenizer) without changing the file.
+	The pages are loaded by the system on first access, so only the touched part of the file is read.
+*/
+class MappedFile
+{
+
+private:
+
+	char* data = nullptr;
+	std::size_t length = 0;
+
+	void unmap() noexcept;
+
+public:
+
+	MappedFile() = default;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+
+	/**
+		@brief Maps the file, the previously mapped file is unmapped.
+		@return TRUE if the file was mapped, FALSE if it cannot be opened or mapped.
+		@param path path of the file.
+	*/
+	bool open(const char* path) noexcept;
+
+	/**
+		@brief Unmaps the file.
+	*/
+	void close() noexcept;
+
+	/**
+		@brief Returns the mapped bytes, nullptr if the file is empty or not mapped.
+	*/
+	char* begin() const noexcept;
+
+	/**
+		@brief Returns the size of the mapped file.
+	*/
+	std::size_t size() const noexcept;
+};
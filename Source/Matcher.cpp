@@ -0,0 +1,446 @@
+#include "ArgsManager.h"
+
+Matcher::Matcher(const ParserPlan& plan, ParseResult& result, bool storeValues, bool strict, bool terminates) :
+	plan(plan), result(result), storeValues(storeValues), strict(strict), terminates(terminates)
+{
+	result.reset(plan);
+
+#ifdef ARGSMANAGER_STATS
+	phaseStart = std::chrono::steady_clock::now();
+#endif
+}
+
+#ifdef ARGSMANAGER_STATS
+void Matcher::endPhase(ParsePhase phase) noexcept
+{
+	const auto now = std::chrono::steady_clock::now();
+	result.stats().phaseNanos[static_cast<std::size_t>(phase)] +=
+		static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - phaseStart).count());
+	phaseStart = now;
+}
+#endif
+
+ArgId Matcher::find(std::string_view token) const noexcept
+{
+#ifdef ARGSMANAGER_STATS
+	ParseStats& stats = result.stats();
+	const std::uint64_t comparisons = CountingNameEqual::comparisons;
+
+	const ArgId id = plan.find(token);
+
+	++stats.lookups;
+	stats.nameComparisons += CountingNameEqual::comparisons - comparisons;
+	return id;
+#else
+	return plan.find(token);
+#endif
+}
+
+bool Matcher::expectsContent() const noexcept
+{
+	return pending != ParserPlan::npos && required != 0;
+}
+
+ArgId Matcher::pendingArgument() const noexcept
+{
+	return pending;
+}
+
+bool Matcher::optionsEnded() const noexcept
+{
+	return ended;
+}
+
+void Matcher::start(ArgId id, std::uint32_t idx)
+{
+	const bool first = result.add(id, Content());
+	const std::uint32_t arity = plan.argumentArity(id);
+	if (arity == 0)
+		return;
+
+	pending = id;
+	pendingToken = idx;
+	collect = first || (plan.argumentFlags(id) & ParserPlan::repeatable);
+
+	if (!collect) {
+		required = 0;
+		optional = arity;
+	}
+	else if (arity == Argument::variadic) {
+		required = 1;
+		optional = Argument::variadic;
+	}
+	else {
+		required = arity;
+		optional = 0;
+	}
+}
+
+ParseError Matcher::content(std::string_view token, std::uint32_t idx)
+{
+	ParseError error;
+
+	if (collect) {
+		TypedValue typed;
+		const ValueType type = plan.argumentType(pending);
+
+		if (type != ValueType::string && !convertValue(type, plan.argument(pending).getChoices(), token, typed))
+			error = { ParseErrc::invalidValue, idx, pending };
+		else
+			result.addValue(pending, storeValues ? result.storeValue(token) : token, typed);
+	}
+
+	if (required != 0)
+		--required;
+	else if (optional != Argument::variadic)
+		--optional;
+
+	if (required == 0 && optional == 0)
+		pending = ParserPlan::npos;
+	return error;
+}
+
+ParseError Matcher::attached(ArgId id, std::string_view value, std::uint32_t idx)
+{
+	if (plan.argumentArity(id) == 0)
+		return { ParseErrc::unexpectedValue, idx, id };
+
+	// The value is content even if it starts with '-'
+	start(id, idx);
+	return content(value, idx);
+}
+
+ParseError Matcher::joined(std::string_view token, TokenKind kind, std::uint32_t split, std::uint32_t idx, bool& matched)
+{
+	matched = false;
+
+	if (kind == TokenKind::longOptionValue) {
+		const ArgId id = find(token.substr(0, split));
+		if (id == ParserPlan::npos)
+			return {};
+
+		matched = true;
+		return attached(id, token.substr(split + 1), idx);
+	}
+
+	if (kind != TokenKind::shortOption || token.size() <= 2)
+		return {};
+
+	// The first pass checks that each character is a short name, so a token of unknown names records nothing
+	for (int record = 0; record < 2; ++record) {
+		for (std::size_t pos = 1; pos < token.size(); ++pos) {
+			const char name[2] = { '-', token[pos] };
+			const ArgId id = find(std::string_view(name, 2));
+			if (id == ParserPlan::npos)
+				return {};
+
+			if (record)
+				start(id, idx);
+
+			// The rest of the token is the content, otherwise the argument takes the following tokens
+			if (plan.argumentArity(id) != 0) {
+				if (record && pos + 1 < token.size())
+					return content(token.substr(pos + 1), idx);
+				break;
+			}
+		}
+
+		// Set once every character of the bundle is known
+		matched = true;
+	}
+
+	return {};
+}
+
+ParseError Matcher::unknown(std::string_view token, TokenKind kind, std::uint32_t split, std::uint32_t idx)
+{
+	// A single '-' usually names the standard input
+	if ((kind != TokenKind::shortOption && kind != TokenKind::longOption && kind != TokenKind::longOptionValue) || token == "-")
+		return {};
+
+	const std::string_view name = (kind == TokenKind::longOptionValue) ? token.substr(0, split) : token;
+
+	if (kind != TokenKind::shortOption) {
+		bool ambiguous = false;
+		const ArgId id = plan.findAbbreviation(name, ambiguous);
+		if (ambiguous)
+			return { ParseErrc::ambiguousArgument, idx };
+
+		if (id != ParserPlan::npos) {
+			if (kind == TokenKind::longOptionValue)
+				return attached(id, token.substr(split + 1), idx);
+
+			start(id, idx);
+			return {};
+		}
+	}
+
+	const std::vector<ArgId> nearest = plan.suggest(name, ParseError::maxSuggestions);
+	ParseError error{ ParseErrc::unknownArgument, idx };
+	if (!nearest.empty())
+		error.arg = nearest.front();
+	for (std::size_t rank = 1; rank < nearest.size(); ++rank)
+		error.alternatives[rank - 1] = nearest[rank];
+	return error;
+}
+
+ParseError Matcher::setting(ArgId id, const ConfigFile::Entry& entry, std::uint32_t file)
+{
+	ParseError invalid{ ParseErrc::invalidConfigValue, entry.line, id };
+	invalid.configFile = file;
+	const std::uint32_t arity = plan.argumentArity(id);
+	const ValueType type = plan.argumentType(id);
+	const auto& choices = plan.argument(id).getChoices();
+	TypedValue typed;
+
+	// A key without value passes the argument without content
+	if (arity == 0) {
+		if (entry.hasValue && !convertValue(ValueType::boolean, choices, entry.value, typed))
+			return invalid;
+
+		if (!entry.hasValue || typed.integer != 0)
+			result.add(id, Content(), ValueSource::configFile);
+		return {};
+	}
+
+	if (!entry.hasValue)
+		return invalid;
+
+	// The values of an argument with arity are separated by whitespace, a single value is taken as a whole
+	const auto values = [&](auto&& function) {
+		if (arity == 1)
+			return function(entry.value);
+
+		bool valid = true;
+		std::string_view rest = entry.value;
+		std::string_view value;
+		while (valid && ConfigFile::nextValue(rest, value))
+			valid = function(value);
+		return valid;
+	};
+
+	std::uint32_t count = 0;
+	const bool valid = values([&](std::string_view value) {
+		++count;
+		return type == ValueType::string || convertValue(type, choices, value, typed);
+	});
+
+	if (!valid || count == 0 || (arity != Argument::variadic && count != arity))
+		return invalid;
+
+	const bool first = result.add(id, Content(), ValueSource::configFile);
+	if (!first && !(plan.argumentFlags(id) & ParserPlan::repeatable))
+		return {};
+
+	// The values are views into the mapped file
+	values([&](std::string_view value) {
+		if (type != ValueType::string)
+			convertValue(type, choices, value, typed);
+		result.addValue(id, value, typed);
+		return true;
+	});
+	return {};
+}
+
+ParseError Matcher::token(std::string_view token, std::uint32_t idx)
+{
+	std::uint32_t split;
+	const TokenKind kind = TokenClassifier::classify(token, split);
+	return this->token(token, kind, split, idx);
+}
+
+ParseError Matcher::token(std::string_view token, TokenKind kind, std::uint32_t split, std::uint32_t idx)
+{
+	// After an error the state stays consistent, so the following tokens can still be matched
+	ParseError error;
+
+#ifdef ARGSMANAGER_STATS
+	++result.stats().tokens;
+#endif
+
+	// The tokens following "--" are operands, even if they start with '-'
+	if (ended)
+		return error;
+
+	if (pending != ParserPlan::npos) {
+		if (plan.takesContent(pending, token, kind))
+			return content(token, idx);
+
+		// The token is matched as an argument even if the content is missing
+		if (required != 0)
+			error = { ParseErrc::missingContent, pendingToken, pending };
+
+		pending = ParserPlan::npos;
+	}
+
+	if (kind == TokenKind::terminator && terminates) {
+		ended = true;
+		return error;
+	}
+
+	// A registered name is matched as a whole, even if it contains '='
+	const ArgId id = find(token);
+	if (id != ParserPlan::npos) {
+		start(id, idx);
+		return error;
+	}
+
+	bool matched = false;
+	ParseError joinedError = joined(token, kind, split, idx, matched);
+	if (!matched && strict)
+		joinedError = unknown(token, kind, split, idx);
+
+	return error ? error : joinedError;
+}
+
+ParseError Matcher::finish(const ParseOptions& options, bool collectAll)
+{
+	ParseError first;
+
+	// Returns TRUE if the checks should stop
+	const auto report = [&](const ParseError& error) {
+		if (!first)
+			first = error;
+		if (collectAll)
+			result.addError(error);
+		return !collectAll;
+	};
+
+#ifdef ARGSMANAGER_STATS
+	endPhase(ParsePhase::match);
+#endif
+
+	if (expectsContent() && report({ ParseErrc::missingContent, pendingToken, pending }))
+		return first;
+
+	// The arguments missing from the command line are read from the configuration files, then from the environment.
+	// A source decides the argument for the sources below it, even if it sets a flag to false
+	std::pmr::vector<std::uint64_t> decided(result.getResource());
+	const auto isDecided = [&](ArgId id) {
+		if (options.configCount == 0)
+			return result.argOccurrences(id) != 0;
+		return ((decided[id / ParserPlan::wordBits] >> (id % ParserPlan::wordBits)) & 1) != 0;
+	};
+
+	if (options.configCount != 0) {
+		decided = result.presenceMask();
+		std::pmr::vector<std::uint64_t> above(result.getResource());
+
+		for (std::size_t file = options.configCount; file-- != 0;) {
+			// A setting repeated in the same file is collected like a repeated argument
+			above = decided;
+
+			for (const ConfigFile::Entry& entry : options.configFiles[file].entries()) {
+				const ArgId id = plan.findConfigKey(entry.key);
+				if (id == ParserPlan::npos || ((above[id / ParserPlan::wordBits] >> (id % ParserPlan::wordBits)) & 1))
+					continue;
+
+				decided[id / ParserPlan::wordBits] |= std::uint64_t(1) << (id % ParserPlan::wordBits);
+
+				const ParseError error = setting(id, entry, static_cast<std::uint32_t>(file));
+				if (error && report(error))
+					return first;
+			}
+		}
+	}
+
+	// The environment is scanned once
+	std::uint32_t unseen = plan.environmentCount();
+	const char* const* environment = (options.environment != nullptr) ? options.environment : ParserPlan::processEnvironment();
+
+	// A variable repeated in the block is read at its first entry, as by getenv()
+	std::pmr::vector<std::uint64_t> seen(result.getResource());
+	if (unseen != 0)
+		seen.assign(plan.wordCount(), 0);
+
+	for (; unseen != 0 && environment != nullptr && *environment != nullptr; ++environment) {
+		const std::string_view entry(*environment);
+
+		// Names of the hidden variables of Windows start with '='
+		const std::size_t equals = entry.find('=', 1);
+		if (equals == std::string_view::npos)
+			continue;
+
+		const ArgId id = plan.findEnvironment(entry.substr(0, equals));
+		if (id == ParserPlan::npos)
+			continue;
+
+		// Each variable is read once, the scan ends when all were seen
+		const std::uint64_t bit = std::uint64_t(1) << (id % ParserPlan::wordBits);
+		if (seen[id / ParserPlan::wordBits] & bit)
+			continue;
+
+		seen[id / ParserPlan::wordBits] |= bit;
+		--unseen;
+		if (isDecided(id))
+			continue;
+
+		const std::string_view value = entry.substr(equals + 1);
+		const ValueType type = (plan.argumentArity(id) == 0) ? ValueType::boolean : plan.argumentType(id);
+		TypedValue typed;
+
+		if (type != ValueType::string && !convertValue(type, plan.argument(id).getChoices(), value, typed)) {
+			if (report({ ParseErrc::invalidEnvironment, ParseError::noToken, id }))
+				return first;
+			continue;
+		}
+
+		if (plan.argumentArity(id) == 0) {
+			if (typed.integer != 0)
+				result.add(id, Content(), ValueSource::environment);
+			continue;
+		}
+
+		// The environment may change after the parse, so the value is always copied
+		result.add(id, Content(), ValueSource::environment);
+		result.addValue(id, result.storeValue(value), typed);
+	}
+
+	result.groupValues();
+	if (options.content == ContentMode::copy)
+		result.copyContent();
+	result.sealContent();
+
+#ifdef ARGSMANAGER_STATS
+	endPhase(ParsePhase::content);
+#endif
+
+	const auto& matched = result.presenceMask();
+	const auto& requiredMask = plan.getRequiredMask();
+
+	// Required arguments
+	for (std::size_t wordIdx = 0; wordIdx < matched.size(); ++wordIdx) {
+		const std::uint64_t missing = requiredMask[wordIdx] & ~matched[wordIdx];
+
+		for (std::size_t bit = 0; missing != 0 && bit < ParserPlan::wordBits; ++bit) {
+			if (!((missing >> bit) & 1))
+				continue;
+
+			const ArgId id = static_cast<ArgId>(wordIdx * ParserPlan::wordBits + bit);
+			if (report({ ParseErrc::missingRequired, ParseError::noToken, id }))
+				return first;
+		}
+	}
+
+#ifdef ARGSMANAGER_STATS
+	endPhase(ParsePhase::required);
+#endif
+
+	// Required arguments set
+	if (plan.requiresSet()) {
+		const auto& requiredSetMask = plan.getRequiredSetMask();
+		bool paramFound = false;
+
+		for (std::size_t wordIdx = 0; wordIdx < matched.size() && !paramFound; ++wordIdx)
+			paramFound = (requiredSetMask[wordIdx] & matched[wordIdx]) != 0;
+
+		if (!paramFound)
+			report({ ParseErrc::missingRequiredFromSet });
+
+#ifdef ARGSMANAGER_STATS
+		endPhase(ParsePhase::requiredSet);
+#endif
+	}
+
+	return first;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "ParserPlan.h"
+#include "ParseResult.h"
+#include "ParseError.h"
+#include "TokenClassifier.h"
+#include "ConfigFile.h"
+
+/**
+	@brief
+	Single pass state machine matching a stream of tokens against a plan.
+	Each token is resolved through the name index of the plan; the matcher keeps track
+	of the argument waiting for its content and of the content tokens it may still take.
+	A token which is not a registered name may still join names and content:
+	--name=value, -ofile (attached content of -o) and -xvf (bundle of -x, -v and -f, the last one may take content).
+	The names and the attached content are views into the token, nothing is allocated to split it.
+	Other tokens are ignored, unless the matcher is strict.
+	With ParseOptions::optionsTerminator, the token "--" ends the options (POSIX): the following tokens are operands.
+	It is the common core of ParserPlan::parse(), ParserPlan::parseCommandLine() and IncrementalParser.
+	With ARGSMANAGER_STATS it also fills the counters of the result (see ParseResult::stats()),
+	the match phase lasts from the construction to finish().
+*/
+class Matcher
+{
+
+private:
+
+	const ParserPlan& plan;
+	ParseResult& result;
+	bool storeValues;
+	bool strict;
+	bool terminates;
+
+	// Argument taking the following content tokens
+	ArgId pending = ParserPlan::npos;
+	std::uint32_t pendingToken = 0;
+
+	// Content tokens the pending argument requires and may take in addition
+	std::uint32_t required = 0;
+	std::uint32_t optional = 0;
+
+	// Content of a repeated argument which is not repeatable is skipped, so it is not taken for an argument
+	bool collect = false;
+
+	// Set by "--", the following tokens are not matched
+	bool ended = false;
+
+#ifdef ARGSMANAGER_STATS
+	// Start of the current phase
+	std::chrono::steady_clock::time_point phaseStart;
+
+	void endPhase(ParsePhase phase) noexcept;
+#endif
+
+	ArgId find(std::string_view token) const noexcept;
+
+	// Records an occurrence of the argument, which then waits for its content
+	void start(ArgId id, std::uint32_t idx);
+
+	// Takes the token as the content of the pending argument
+	ParseError content(std::string_view token, std::uint32_t idx);
+
+	// Records the argument with the content attached to its name
+	ParseError attached(ArgId id, std::string_view value, std::uint32_t idx);
+
+	// Matches a token which is not a registered name: --name=value, -ofile or -xvf
+	ParseError joined(std::string_view token, TokenKind kind, std::uint32_t split, std::uint32_t idx, bool& matched);
+
+	// Matches an abbreviated long name or reports the unknown option, in strict mode
+	ParseError unknown(std::string_view token, TokenKind kind, std::uint32_t split, std::uint32_t idx);
+
+	// Records the setting of the configuration file of index file for the argument
+	ParseError setting(ArgId id, const ConfigFile::Entry& entry, std::uint32_t file);
+
+public:
+
+	/**
+		@brief constructor, resets the result for the plan.
+		@param plan plan of the parse, must outlive the matcher.
+		@param result receives the matched arguments, must outlive the matcher.
+		@param storeValues TRUE to copy the content into the result when it is matched,
+		so the tokens do not need to outlive the call of token().
+		@param strict TRUE to report the unknown options and to accept the abbreviated long names (see ParseOptions::strict).
+		@param terminates TRUE to end the options at the token "--" (see ParseOptions::optionsTerminator).
+	*/
+	Matcher(const ParserPlan& plan, ParseResult& result, bool storeValues = false, bool strict = false, bool terminates = false);
+
+	/**
+		@brief Returns TRUE if the pending argument requires more content, otherwise FALSE.
+	*/
+	bool expectsContent() const noexcept;
+
+	/**
+		@brief Returns the handle of the argument waiting for its content, ParserPlan::npos if there is none.
+	*/
+	ArgId pendingArgument() const noexcept;
+
+	/**
+		@brief Returns TRUE if the token "--" ended the options: the following tokens are operands and are not matched.
+	*/
+	bool optionsEnded() const noexcept;
+
+	/**
+		@brief Matches the next token.
+		@return The error caused by the token, ParseErrc::none if the token is valid.
+		The matcher recovers from the error, so the following tokens can still be matched.
+		@param token token, it must outlive the result unless the values are stored.
+		@param idx index of the token reported in the errors.
+	*/
+	ParseError token(std::string_view token, std::uint32_t idx);
+
+	/**
+		@brief Matches the next token already classified by TokenClassifier.
+		@return The error caused by the token, ParseErrc::none if the token is valid.
+		@param token token, it must outlive the result unless the values are stored.
+		@param kind kind of the token.
+		@param split position of '=' in the token, see TokenClassifier::classify().
+		@param idx index of the token reported in the errors.
+	*/
+	ParseError token(std::string_view token, TokenKind kind, std::uint32_t split, std::uint32_t idx);
+
+	/**
+		@brief Ends the stream of tokens: checks the pending content, reads the missing arguments
+		from the configuration files and the environment, checks the required arguments and the required set.
+		@return The first error, ParseErrc::none if the arguments are valid.
+		@param options storage of the extracted content and environment of the parse.
+		@param collectAll TRUE to record every error in the result (see ParseResult::errors()) instead of stopping at the first one.
+	*/
+	ParseError finish(const ParseOptions& options, bool collectAll = false);
+};
@@ -0,0 +1,137 @@
+#include "ArgsManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+	std::uint64_t mix(std::uint64_t value) noexcept
+	{
+		value ^= value >> 33;
+		value *= 0xFF51AFD7ED558CCDull;
+		value ^= value >> 33;
+		return value;
+	}
+
+	// Maps the 32 bits of the hash to [0, count) with a multiplication instead of a division
+	std::uint32_t reduce(std::uint32_t value, std::uint32_t count) noexcept
+	{
+		return static_cast<std::uint32_t>((std::uint64_t(value) * count) >> 32);
+	}
+
+	std::uint32_t bucketIndex(std::uint64_t hash, std::uint32_t count) noexcept
+	{
+		return reduce(static_cast<std::uint32_t>(hash), count);
+	}
+
+	std::uint32_t slotIndex(std::uint64_t hash, std::uint32_t seed, std::uint32_t count) noexcept
+	{
+		return reduce(static_cast<std::uint32_t>(mix((hash >> 32) ^ (seed * 0x9E3779B97F4A7C15ull)) >> 32), count);
+	}
+
+}
+
+std::uint64_t NameTable::hash(std::string_view name) noexcept
+{
+	std::uint64_t value = 0x9E3779B97F4A7C15ull ^ name.size();
+	std::size_t pos = 0;
+
+	for (; pos + 8 <= name.size(); pos += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, name.data() + pos, 8);
+		value = mix(value ^ word) * 0xC4CEB9FE1A85EC53ull;
+	}
+
+	std::uint64_t tail = 0;
+	for (std::size_t shift = 0; pos < name.size(); ++pos, shift += 8)
+		tail |= std::uint64_t(static_cast<unsigned char>(name[pos])) << shift;
+
+	return mix(value ^ tail) * 0xC4CEB9FE1A85EC53ull;
+}
+
+bool NameTable::generate(const std::vector<std::string_view>& names, std::vector<std::int32_t>& seeds,
+	std::vector<std::uint32_t>& slotOf)
+{
+	const std::uint32_t count = static_cast<std::uint32_t>(names.size());
+	seeds.assign(count, 0);
+	slotOf.assign(count, 0);
+	if (count == 0)
+		return true;
+
+	std::vector<std::uint64_t> hashes(count);
+	std::vector<std::vector<std::uint32_t>> buckets(count);
+	for (std::uint32_t idx = 0; idx < count; ++idx) {
+		hashes[idx] = hash(names[idx]);
+		buckets[bucketIndex(hashes[idx], count)].push_back(idx);
+	}
+
+	// The largest buckets are placed first, while most of the slots are free
+	std::vector<std::uint32_t> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](std::uint32_t left, std::uint32_t right) {
+		return buckets[left].size() > buckets[right].size();
+	});
+
+	std::vector<bool> used(count, false);
+	std::vector<std::uint32_t> taken;
+	std::size_t next = 0;
+
+	for (; next < order.size() && buckets[order[next]].size() > 1; ++next) {
+		const std::vector<std::uint32_t>& bucket = buckets[order[next]];
+
+		// Equal names have equal slots for every seed
+		for (std::size_t idx = 1; idx < bucket.size(); ++idx) {
+			for (std::size_t other = 0; other < idx; ++other) {
+				if (names[bucket[idx]] == names[bucket[other]])
+					return false;
+			}
+		}
+
+		for (std::uint32_t seed = 1;; ++seed) {
+			taken.clear();
+			for (const std::uint32_t idx : bucket) {
+				const std::uint32_t slot = slotIndex(hashes[idx], seed, count);
+				if (used[slot] || std::find(taken.begin(), taken.end(), slot) != taken.end())
+					break;
+				taken.push_back(slot);
+			}
+
+			if (taken.size() != bucket.size())
+				continue;
+
+			for (std::size_t idx = 0; idx < bucket.size(); ++idx) {
+				used[taken[idx]] = true;
+				slotOf[bucket[idx]] = taken[idx];
+			}
+			seeds[order[next]] = static_cast<std::int32_t>(seed);
+			break;
+		}
+	}
+
+	// A single name takes any free slot, stored directly in the seed
+	std::uint32_t slot = 0;
+	for (; next < order.size() && buckets[order[next]].size() == 1; ++next) {
+		while (used[slot])
+			++slot;
+
+		used[slot] = true;
+		slotOf[buckets[order[next]].front()] = slot;
+		seeds[order[next]] = -static_cast<std::int32_t>(slot) - 1;
+	}
+
+	return true;
+}
+
+ArgId NameTable::find(std::string_view name) const noexcept
+{
+	if (seedCount == 0)
+		return ParserPlan::npos;
+
+	const std::uint64_t value = hash(name);
+	const std::int32_t seed = seeds[bucketIndex(value, seedCount)];
+	const std::uint32_t slot = (seed < 0) ? static_cast<std::uint32_t>(-seed - 1) :
+		slotIndex(value, static_cast<std::uint32_t>(seed), slotCount);
+
+	return (slot < slotCount && slots[slot].name == name) ? slots[slot].id : ParserPlan::npos;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "ParserPlan.h"
+
+/**
+	@brief
+	Minimal perfect hash table of the names of the arguments, generated at build time
+	by ArgsManagerNameTable (CMake function argsmanager_name_table()) from a schema file.
+	A name is found with one hash and one comparison: the hash selects the bucket,
+	the seed of the bucket gives the slot; a negative seed is the slot of the single name of its bucket.
+	The arrays are constants of the generated header, nothing is built at run time.
+	Plugged into the plan by ArgsManager::setNameTable(), it replaces the hash map of the names.
+*/
+struct NameTable {
+
+	/**
+		@brief Name of an argument and its handle.
+	*/
+	struct Slot {
+		std::string_view name;
+		ArgId id;
+	};
+
+	const std::int32_t* seeds = nullptr; ///< seed of each bucket.
+	std::uint32_t seedCount = 0;         ///< count of the buckets.
+	const Slot* slots = nullptr;         ///< names, one per slot.
+	std::uint32_t slotCount = 0;         ///< count of the names.
+	std::uint32_t argumentCount = 0;     ///< count of the arguments, the handles are below it.
+
+	/**
+		@brief Hash of the name read 8 bytes at a time: the low half selects the bucket,
+		the high half mixed with the seed of the bucket selects the slot.
+		@param name name of an argument.
+	*/
+	static std::uint64_t hash(std::string_view name) noexcept;
+
+	/**
+		@brief Computes the seeds of the buckets so that every name gets its own slot.
+		@return TRUE on success, FALSE if the names are duplicated.
+		@param names names to place, there is one bucket and one slot per name.
+		@param seeds receives the seed of each bucket.
+		@param slotOf receives the slot of each name.
+	*/
+	static bool generate(const std::vector<std::string_view>& names, std::vector<std::int32_t>& seeds,
+		std::vector<std::uint32_t>& slotOf);
+
+	/**
+		@brief Returns the handle of the argument with the specified name, ParserPlan::npos if there is none.
+		@param name name of the argument.
+	*/
+	ArgId find(std::string_view name) const noexcept;
+};
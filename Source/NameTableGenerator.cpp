@@ -0,0 +1,195 @@
+/**
+	Generator of the perfect hash table of the names of the arguments (see NameTable), run at build time
+	by the CMake function argsmanager_name_table().
+
+	Usage: ArgsManagerNameTable <schema> <header> [namespace]
+	The schema has one argument per line: "<kind> <name> [<name>]", kind is flag, value,
+	required-flag or required-value; empty lines and lines starting with '#' are skipped.
+	The header defines, in the namespace (args by default): the StaticArgument array of the arguments,
+	the arrays of the table, the NameTable names and registerTo(ArgsManager&).
+*/
+
+#include "ArgsManager.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+	struct SchemaArgument {
+		std::string arg1;
+		std::string arg2;
+		bool hasContent = false;
+		bool required = false;
+	};
+
+	bool readSchema(const char* path, std::vector<SchemaArgument>& schema)
+	{
+		std::ifstream file(path);
+		if (!file) {
+			std::fprintf(stderr, "%s: cannot be read\n", path);
+			return false;
+		}
+
+		std::string line;
+		for (std::size_t number = 1; std::getline(file, line); ++number) {
+			std::istringstream fields(line);
+			std::string kind;
+			if (!(fields >> kind) || kind[0] == '#')
+				continue;
+
+			SchemaArgument argument;
+			argument.required = kind.compare(0, 9, "required-") == 0;
+			if (argument.required)
+				kind.erase(0, 9);
+
+			std::string rest;
+			if ((kind != "flag" && kind != "value") || !(fields >> argument.arg1)
+				|| ((fields >> argument.arg2) && (fields >> rest))) {
+				std::fprintf(stderr, "%s:%zu: expected \"<kind> <name> [<name>]\"\n", path, number);
+				return false;
+			}
+
+			argument.hasContent = kind == "value";
+			schema.push_back(std::move(argument));
+		}
+
+		if (schema.empty()) {
+			std::fprintf(stderr, "%s: no arguments\n", path);
+			return false;
+		}
+
+		return true;
+	}
+
+	// Literal of the name, the characters other than printable ASCII are escaped
+	std::string literal(const std::string& name)
+	{
+		std::string text = "\"";
+		for (const char c : name) {
+			if (c == '"' || c == '\\') {
+				text += '\\';
+				text += c;
+			}
+			else if (c < 0x20 || c > 0x7E) {
+				char octal[8];
+				std::snprintf(octal, sizeof(octal), "\\%03o", static_cast<unsigned char>(c));
+				text += octal;
+			}
+			else
+				text += c;
+		}
+		return text + '"';
+	}
+
+	bool writeHeader(const char* path, const char* ns, const std::vector<SchemaArgument>& schema,
+		const std::vector<std::string_view>& names, const std::vector<ArgId>& ids,
+		const std::vector<std::int32_t>& seeds, const std::vector<std::uint32_t>& slotOf)
+	{
+		std::ostringstream out;
+		out << "// Generated by ArgsManagerNameTable, do not edit.\n"
+			"#pragma once\n\n"
+			"#include \"StaticSchema.h\"\n\n"
+			"namespace " << ns << " {\n\n";
+
+		out << "\tinline constexpr StaticArgument arguments[] = {\n";
+		for (const SchemaArgument& argument : schema) {
+			out << "\t\tStaticArgument(" << (argument.hasContent ? "true" : "false") << ", " << literal(argument.arg1);
+			if (!argument.arg2.empty())
+				out << ", " << literal(argument.arg2);
+			out << ")" << (argument.required ? ".required()" : "") << ",\n";
+		}
+		out << "\t};\n\n";
+
+		out << "\tinline constexpr std::int32_t seeds[] = {";
+		for (std::size_t idx = 0; idx < seeds.size(); ++idx)
+			out << ((idx % 16 == 0) ? "\n\t\t" : " ") << seeds[idx] << ",";
+		out << "\n\t};\n\n";
+
+		std::vector<std::size_t> nameOfSlot(names.size());
+		for (std::size_t idx = 0; idx < names.size(); ++idx)
+			nameOfSlot[slotOf[idx]] = idx;
+
+		out << "\tinline constexpr NameTable::Slot slots[] = {\n";
+		for (const std::size_t idx : nameOfSlot)
+			out << "\t\t{ " << literal(std::string(names[idx])) << ", " << ids[idx] << " },\n";
+		out << "\t};\n\n";
+
+		out << "\tinline constexpr NameTable names = { seeds, " << seeds.size() << ", slots, " << names.size()
+			<< ", " << schema.size() << " };\n\n";
+
+		out << "\t/**\n"
+			"\t\t@brief Registers the arguments in the order of the table and plugs the table into the plan.\n"
+			"\t\t@return Reference to the manager.\n"
+			"\t\t@throw If the manager already has arguments.\n"
+			"\t\t@param manager manager receiving the arguments.\n"
+			"\t*/\n"
+			"\tinline ArgsManager& registerTo(ArgsManager& manager)\n"
+			"\t{\n"
+			"\t\tfor (const StaticArgument& argument : arguments) {\n"
+			"\t\t\tif (argument.isRequired())\n"
+			"\t\t\t\tmanager.addRequired(argument.toArgument());\n"
+			"\t\t\telse\n"
+			"\t\t\t\tmanager.addOptional(argument.toArgument());\n"
+			"\t\t}\n\n"
+			"\t\treturn manager.setNameTable(&names);\n"
+			"\t}\n\n"
+			"}\n";
+
+		// The header is rewritten only if it changed, so the files including it are not rebuilt
+		const std::string text = out.str();
+		std::ifstream previous(path, std::ios::binary);
+		if (previous) {
+			std::ostringstream content;
+			content << previous.rdbuf();
+			if (content.str() == text)
+				return true;
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << text;
+		if (!file) {
+			std::fprintf(stderr, "%s: cannot be written\n", path);
+			return false;
+		}
+
+		return true;
+	}
+
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3 || argc > 4) {
+		std::fprintf(stderr, "Usage: %s <schema> <header> [namespace]\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<SchemaArgument> schema;
+	if (!readSchema(argv[1], schema))
+		return 1;
+
+	std::vector<std::string_view> names;
+	std::vector<ArgId> ids;
+	for (std::size_t idx = 0; idx < schema.size(); ++idx) {
+		for (const std::string* name : { &schema[idx].arg1, &schema[idx].arg2 }) {
+			if (name->empty() || (name == &schema[idx].arg2 && *name == schema[idx].arg1))
+				continue;
+
+			names.push_back(*name);
+			ids.push_back(static_cast<ArgId>(idx));
+		}
+	}
+
+	std::vector<std::int32_t> seeds;
+	std::vector<std::uint32_t> slotOf;
+	if (!NameTable::generate(names, seeds, slotOf)) {
+		std::fprintf(stderr, "%s: a name is given to two arguments\n", argv[1]);
+		return 1;
+	}
+
+	return writeHeader(argv[2], (argc == 4) ? argv[3] : "args", schema, names, ids, seeds, slotOf) ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ParserPlan.h"
+
+/**
+	@brief Codes of the errors detected while parsing.
+*/
+enum class ParseErrc : std::uint8_t {
+	none = 0,
+	noArguments,            ///< argc == 0 but arguments are required.
+	nullArgv,               ///< argv is NULL pointer.
+	beginOutOfRange,        ///< beginIdx > argc.
+	nullArgument,           ///< an element of argv is NULL pointer.
+	missingContent,         ///< an argument with content is not followed by its content.
+	missingRequired,        ///< a required argument was not passed.
+	missingRequiredFromSet, ///< no argument of the required set was passed.
+	unterminatedQuote,      ///< the command line ends inside of quotes.
+	responseFileNotRead,    ///< a response file cannot be opened or mapped.
+	responseFileCycle,      ///< a response file includes itself directly or through other files.
+	invalidValue,           ///< the content cannot be converted to the type of the argument.
+	unexpectedValue,        ///< --name=value names an argument without content.
+	invalidEnvironment,     ///< the environment variable of a missing argument is not a valid value.
+	invalidConfigValue,     ///< a value of a configuration file is missing or not valid, the token is the index of the line in the file configFile.
+	unknownArgument,        ///< strict parse: an option names no argument, the argument is the nearest name or npos, followed by the alternatives.
+	ambiguousArgument,      ///< strict parse: an abbreviated long name begins the names of several arguments.
+	outOfMemory             ///< the storage of the parse could not be allocated.
+};
+
+/**
+	@brief
+	Error detected while parsing: the code, the index of the token in argv and the argument concerned.
+	The message is not formatted until ParserPlan::errorMessage() is called.
+*/
+struct ParseError {
+	static constexpr std::uint32_t noToken = ~std::uint32_t(0);
+	// Count of the suggestions of ParseErrc::unknownArgument: the argument and the alternatives
+	static constexpr std::size_t maxSuggestions = 3;
+
+	ParseErrc code = ParseErrc::none;
+	std::uint32_t token = noToken;
+	ArgId arg = ParserPlan::npos;
+	// Next nearest names of ParseErrc::unknownArgument after the argument, npos if there are fewer
+	ArgId alternatives[maxSuggestions - 1] = { ParserPlan::npos, ParserPlan::npos };
+	// Index of the file of ParseErrc::invalidConfigValue in ParseOptions::configFiles
+	std::uint32_t configFile = noToken;
+
+	explicit operator bool() const noexcept { return code != ParseErrc::none; }
+};
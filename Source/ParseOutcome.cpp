@@ -0,0 +1,55 @@
+#include "ArgsManager.h"
+
+namespace {
+
+	const ParseError noError;
+
+}
+
+ParseOutcome::ParseOutcome(const ParserPlan* plan, ParseResult& result, ParseError fatal,
+	const ParseOptions& options) noexcept :
+	plan(plan), result(&result), fatal(fatal), options(options) {}
+
+bool ParseOutcome::hasValue() const noexcept
+{
+	return errorCount() == 0;
+}
+
+ParseOutcome::operator bool() const noexcept
+{
+	return hasValue();
+}
+
+ParseResult& ParseOutcome::value() const
+{
+	if (!hasValue()) {
+		if (plan == nullptr)
+			throw std::bad_alloc();
+		plan->throwError(error(), options);
+	}
+
+	return *result;
+}
+
+std::size_t ParseOutcome::errorCount() const noexcept
+{
+	return fatal ? 1 : result->errors().size();
+}
+
+const ParseError& ParseOutcome::error(std::size_t idx) const noexcept
+{
+	if (fatal)
+		return (idx == 0) ? fatal : noError;
+
+	const auto& errors = result->errors();
+	return (idx < errors.size()) ? errors[idx] : noError;
+}
+
+std::string ParseOutcome::message(std::size_t idx) const
+{
+	const ParseError& found = error(idx);
+	if (!found)
+		return std::string();
+
+	return (plan != nullptr) ? plan->errorMessage(found, options) : "Out of memory.";
+}
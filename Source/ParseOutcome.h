@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "ParserPlan.h"
+#include "ParseResult.h"
+#include "ParseError.h"
+
+/**
+	@brief
+	Outcome of ParserPlan::tryParseAll(): either the parsed result or every error found in one pass,
+	each with its code, token index and argument. No message is formatted until message() is called.
+	The outcome refers to the plan, the result and the configuration files of the parse, which must outlive it.
+*/
+class ParseOutcome
+{
+
+private:
+
+	const ParserPlan* plan;
+	ParseResult* result;
+
+	// Error which stopped the parse before the arguments were matched
+	ParseError fatal;
+
+	// Options of the parse, the messages name the configuration files
+	ParseOptions options;
+
+public:
+
+	/**
+		@brief constructor.
+		@param plan plan of the parse, NULL only when the plan could not be allocated.
+		@param result result of the parse holding the collected errors.
+		@param fatal error which stopped the parse, the errors of the result are ignored if it is set.
+		@param options options of the parse.
+	*/
+	ParseOutcome(const ParserPlan* plan, ParseResult& result, ParseError fatal = ParseError(),
+		const ParseOptions& options = ParseOptions()) noexcept;
+
+	/**
+		@brief Returns TRUE if the arguments are valid, otherwise FALSE.
+	*/
+	bool hasValue() const noexcept;
+
+	/**
+		@brief Returns TRUE if the arguments are valid, otherwise FALSE.
+	*/
+	explicit operator bool() const noexcept;
+
+	/**
+		@brief Returns the parsed arguments.
+		@throw The exception of the first error, as thrown by ParserPlan::parse().
+	*/
+	ParseResult& value() const;
+
+	/**
+		@brief Returns the count of errors.
+	*/
+	std::size_t errorCount() const noexcept;
+
+	/**
+		@brief Returns the error, ParseErrc::none if idx is out of range.
+		@param idx index of the error in the order they were found.
+	*/
+	const ParseError& error(std::size_t idx = 0) const noexcept;
+
+	/**
+		@brief Formats the message of the error.
+		@return Message describing the error, empty if idx is out of range.
+		@param idx index of the error in the order they were found.
+	*/
+	std::string message(std::size_t idx = 0) const;
+};
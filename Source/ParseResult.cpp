@@ -0,0 +1,456 @@
+#include "ArgsManager.h"
+
+#include <algorithm>
+#include <cassert>
+
+ParseResult::ParseResult() :
+	ParseResult(std::pmr::get_default_resource()) {}
+
+ParseResult::ParseResult(std::pmr::memory_resource* resource) :
+	resource(resource),
+	presence(resource), valueData(resource), valueSize(resource), occurrences(resource), sources(resource),
+	values(resource), valueOwners(resource), valueBegin(resource), groupedValues(resource),
+	typedValues(resource), groupedTypedValues(resource), parseErrors(resource),
+	checksums(resource), contentStorage(resource), files(resource), storedBlocks(resource)
+{
+	if (resource == nullptr)
+		throw std::invalid_argument("Pointer resource is NULL!");
+}
+
+ParseResult& ParseResult::operator=(ParseResult&& other)
+{
+	if (this == &other)
+		return *this;
+
+	// The containers keep the resource of this result, as std::pmr containers do
+	const bool sameResource = *resource == *other.resource;
+
+	try {
+		planOwner = std::move(other.planOwner);
+		plan = other.plan;
+		presence = std::move(other.presence);
+		valueData = std::move(other.valueData);
+		valueSize = std::move(other.valueSize);
+		occurrences = std::move(other.occurrences);
+		sources = std::move(other.sources);
+		values = std::move(other.values);
+		valueOwners = std::move(other.valueOwners);
+		valueBegin = std::move(other.valueBegin);
+		groupedValues = std::move(other.groupedValues);
+		typedValues = std::move(other.typedValues);
+		groupedTypedValues = std::move(other.groupedTypedValues);
+		parseErrors = std::move(other.parseErrors);
+		checksums = std::move(other.checksums);
+#ifdef ARGSMANAGER_STATS
+		parseStats = other.parseStats;
+#endif
+
+		if (sameResource) {
+			contentStorage = std::move(other.contentStorage);
+			files = std::move(other.files);
+			storedBlocks = std::move(other.storedBlocks);
+			storedNext = other.storedNext;
+			storedFree = other.storedFree;
+		}
+		else {
+			contentStorage.clear();
+			files.clear();
+			releaseStored();
+
+			// The views still point into the storage of other, the content is copied from there
+			if (plan != nullptr)
+				copyContent();
+		}
+	}
+	catch (...) {
+		reset();
+		other.reset();
+		throw;
+	}
+
+	other.reset();
+	return *this;
+}
+
+void ParseResult::checkParsed() const
+{
+	if (plan == nullptr)
+		throw std::runtime_error("Parsing failed");
+}
+
+void ParseResult::reset(const ParserPlan& plan)
+{
+	const std::uint32_t argCount = plan.size();
+
+#ifdef ARGSMANAGER_STATS
+	parseStats = ParseStats();
+#endif
+	countGrowth(presence, plan.wordCount());
+	countGrowth(valueData, argCount);
+	countGrowth(valueSize, argCount);
+	countGrowth(occurrences, argCount);
+	countGrowth(sources, argCount);
+	countGrowth(valueBegin, argCount + 1);
+
+	planOwner = plan.weak_from_this().lock();
+	this->plan = &plan;
+
+	presence.assign(plan.wordCount(), 0);
+	valueData.assign(argCount, nullptr);
+	valueSize.assign(argCount, 0);
+	occurrences.assign(argCount, 0);
+	sources.assign(argCount, ValueSource::none);
+	values.clear();
+	typedValues.clear();
+	valueOwners.clear();
+	valueBegin.assign(argCount + 1, 0);
+	contentStorage.clear();
+	files.clear();
+	releaseStored();
+	parseErrors.clear();
+
+#ifndef NDEBUG
+	checksums.assign(argCount, 0);
+#endif
+}
+
+void ParseResult::reset()
+{
+	planOwner.reset();
+	plan = nullptr;
+
+	presence.clear();
+	valueData.clear();
+	valueSize.clear();
+	occurrences.clear();
+	sources.clear();
+	values.clear();
+	typedValues.clear();
+	valueOwners.clear();
+	valueBegin.clear();
+	checksums.clear();
+	contentStorage.clear();
+	files.clear();
+	releaseStored();
+	parseErrors.clear();
+}
+
+bool ParseResult::add(ArgId id, Content content, ValueSource source)
+{
+	if (occurrences[id]++ != 0)
+		return false;
+
+	sources[id] = source;
+	presence[id / ParserPlan::wordBits] |= std::uint64_t(1) << (id % ParserPlan::wordBits);
+	valueData[id] = content.data();
+	valueSize[id] = static_cast<std::uint32_t>(content.size());
+	return true;
+}
+
+void ParseResult::addValue(ArgId id, Content content, const TypedValue& typed)
+{
+	if (valueData[id] == nullptr) {
+		valueData[id] = content.data();
+		valueSize[id] = static_cast<std::uint32_t>(content.size());
+	}
+
+	countGrowth(values, values.size() + 1);
+	countGrowth(typedValues, typedValues.size() + 1);
+	countGrowth(valueOwners, valueOwners.size() + 1);
+
+	values.push_back(content);
+	typedValues.push_back(typed);
+	valueOwners.push_back(id);
+}
+
+void ParseResult::addError(const ParseError& error)
+{
+	countGrowth(parseErrors, parseErrors.size() + 1);
+	parseErrors.push_back(error);
+}
+
+const std::pmr::vector<ParseError>& ParseResult::errors() const noexcept
+{
+	return parseErrors;
+}
+
+Content ParseResult::storeValue(Content value)
+{
+	constexpr std::size_t blockSize = 4096;
+
+	if (value.size() > storedFree) {
+		const std::size_t size = std::max(blockSize, value.size());
+		countGrowth(storedBlocks, storedBlocks.size() + 1);
+#ifdef ARGSMANAGER_STATS
+		++parseStats.allocations;
+#endif
+		storedBlocks.emplace_back(size);
+		storedNext = storedBlocks.back().data();
+		storedFree = size;
+	}
+
+#ifdef ARGSMANAGER_STATS
+	parseStats.bytesCopied += value.size();
+#endif
+
+	char* const copy = storedNext;
+	std::copy(value.begin(), value.end(), copy);
+	storedNext += value.size();
+	storedFree -= value.size();
+	return Content(copy, value.size());
+}
+
+void ParseResult::releaseStored() noexcept
+{
+	storedBlocks.clear();
+	storedNext = nullptr;
+	storedFree = 0;
+}
+
+void ParseResult::groupValues()
+{
+	// Stable counting sort by argument, the values of each argument keep the order of the passed arguments
+	std::fill(valueBegin.begin(), valueBegin.end(), 0);
+	for (const ArgId owner : valueOwners)
+		++valueBegin[owner + 1];
+
+	for (std::size_t idx = 1; idx < valueBegin.size(); ++idx)
+		valueBegin[idx] += valueBegin[idx - 1];
+
+	countGrowth(groupedValues, values.size());
+	countGrowth(groupedTypedValues, typedValues.size());
+	groupedValues.resize(values.size());
+	groupedTypedValues.resize(typedValues.size());
+	for (std::size_t idx = 0; idx < values.size(); ++idx) {
+		const std::uint32_t position = valueBegin[valueOwners[idx]]++;
+		groupedValues[position] = values[idx];
+		groupedTypedValues[position] = typedValues[idx];
+	}
+
+	// Each begin was advanced to the end of its group, which is the begin of the next one
+	for (std::size_t idx = valueBegin.size() - 1; idx > 0; --idx)
+		valueBegin[idx] = valueBegin[idx - 1];
+	valueBegin[0] = 0;
+
+	values.swap(groupedValues);
+	typedValues.swap(groupedTypedValues);
+}
+
+void ParseResult::keepFile(MappedFile&& file)
+{
+	countGrowth(files, files.size() + 1);
+	files.push_back(std::move(file));
+}
+
+void ParseResult::copyContent()
+{
+	std::size_t contentSize = 0;
+	for (const Content value : values)
+		contentSize += value.size();
+
+#ifdef ARGSMANAGER_STATS
+	parseStats.bytesCopied += contentSize;
+#endif
+	countGrowth(contentStorage, contentSize);
+	contentStorage.resize(contentSize);
+
+	char* out = contentStorage.data();
+	for (Content& value : values) {
+		std::copy(value.begin(), value.end(), out);
+		value = Content(out, value.size());
+		out += value.size();
+	}
+
+	for (ArgId id = 0; id < size(); ++id) {
+		if (valueBegin[id] != valueBegin[id + 1])
+			valueData[id] = values[valueBegin[id]].data();
+	}
+
+	files.clear();
+	releaseStored();
+}
+
+void ParseResult::sealContent()
+{
+#ifndef NDEBUG
+	for (std::size_t idx = 0; idx < valueData.size(); ++idx)
+		checksums[idx] = std::hash<Content>()(Content(valueData[idx], valueSize[idx]));
+#endif
+}
+
+bool ParseResult::parsed() const noexcept
+{
+	return plan != nullptr;
+}
+
+const ParserPlan* ParseResult::getPlan() const noexcept
+{
+	return plan;
+}
+
+const ParseStats& ParseResult::stats() const noexcept
+{
+#ifdef ARGSMANAGER_STATS
+	return parseStats;
+#else
+	static const ParseStats disabled;
+	return disabled;
+#endif
+}
+
+#ifdef ARGSMANAGER_STATS
+ParseStats& ParseResult::stats() noexcept
+{
+	return parseStats;
+}
+#endif
+
+std::pmr::memory_resource* ParseResult::getResource() const noexcept
+{
+	return resource;
+}
+
+std::uint32_t ParseResult::size() const noexcept
+{
+	return static_cast<std::uint32_t>(occurrences.size());
+}
+
+const std::pmr::vector<std::uint64_t>& ParseResult::presenceMask() const noexcept
+{
+	return presence;
+}
+
+Content ParseResult::argValue(const Argument& arg) const
+{
+	checkParsed();
+
+	const ArgId id = plan->indexOf(arg);
+
+	if (id == ParserPlan::npos || !argPresent(id))
+		throw InvalidArg("Parameter " + arg.quotedNames() + " not found!");
+
+	return argValue(id);
+}
+
+Content ParseResult::argValue(ArgId id) const
+{
+	if (!argPresent(id))
+		throw InvalidArg("Parameter " + plan->argument(id).quotedNames() + " not found!");
+
+	if (!(plan->argumentFlags(id) & ParserPlan::hasContent))
+		throw std::runtime_error("Parameter " + plan->argument(id).quotedNames() + " has no content!");
+
+	const Content value(valueData[id], valueSize[id]);
+
+	assert((checksums.empty() || checksums[id] == std::hash<Content>()(value))
+		&& "The strings of argv were modified or released after parse()");
+
+	return value;
+}
+
+ValueRange ParseResult::argValues(const Argument& arg) const
+{
+	checkParsed();
+
+	const ArgId id = plan->indexOf(arg);
+
+	if (id == ParserPlan::npos)
+		throw InvalidArg("Parameter " + arg.quotedNames() + " not found!");
+
+	return argValues(id);
+}
+
+ValueRange ParseResult::argValues(ArgId id) const
+{
+	const bool present = argPresent(id);
+
+	if (!(plan->argumentFlags(id) & ParserPlan::hasContent))
+		throw std::runtime_error("Parameter " + plan->argument(id).quotedNames() + " has no content!");
+
+	if (!present)
+		return ValueRange();
+
+	return ValueRange(values.data() + valueBegin[id], values.data() + valueBegin[id + 1]);
+}
+
+const TypedValue& ParseResult::typedValue(ArgId id, std::size_t idx, ValueType type) const
+{
+	if (!argPresent(id))
+		throw InvalidArg("Parameter " + plan->argument(id).quotedNames() + " not found!");
+
+	if (plan->argumentType(id) != type)
+		throw std::runtime_error("Parameter " + plan->argument(id).quotedNames() + " has content of another type!");
+
+	if (idx >= valueBegin[id + 1] - valueBegin[id])
+		throw std::out_of_range("Value index out of range.");
+
+	return typedValues[valueBegin[id] + idx];
+}
+
+std::int64_t ParseResult::argInt(ArgId id, std::size_t idx) const
+{
+	return typedValue(id, idx, ValueType::integer).integer;
+}
+
+double ParseResult::argFloat(ArgId id, std::size_t idx) const
+{
+	return typedValue(id, idx, ValueType::floating).floating;
+}
+
+bool ParseResult::argBool(ArgId id, std::size_t idx) const
+{
+	return typedValue(id, idx, ValueType::boolean).integer != 0;
+}
+
+std::uint64_t ParseResult::argBytes(ArgId id, std::size_t idx) const
+{
+	return static_cast<std::uint64_t>(typedValue(id, idx, ValueType::byteSize).integer);
+}
+
+std::chrono::nanoseconds ParseResult::argDuration(ArgId id, std::size_t idx) const
+{
+	return std::chrono::nanoseconds(typedValue(id, idx, ValueType::duration).integer);
+}
+
+std::size_t ParseResult::argChoice(ArgId id, std::size_t idx) const
+{
+	return static_cast<std::size_t>(typedValue(id, idx, ValueType::choice).integer);
+}
+
+bool ParseResult::argPresent(const Argument& arg) const
+{
+	checkParsed();
+
+	const ArgId id = plan->indexOf(arg);
+	return id != ParserPlan::npos && argPresent(id);
+}
+
+bool ParseResult::argPresent(ArgId id) const
+{
+	checkParsed();
+
+	if (id >= size())
+		throw std::out_of_range("Argument handle out of range.");
+
+	return (presence[id / ParserPlan::wordBits] >> (id % ParserPlan::wordBits)) & 1;
+}
+
+std::uint32_t ParseResult::argOccurrences(ArgId id) const
+{
+	checkParsed();
+
+	if (id >= size())
+		throw std::out_of_range("Argument handle out of range.");
+
+	return occurrences[id];
+}
+
+ValueSource ParseResult::argSource(ArgId id) const
+{
+	checkParsed();
+
+	if (id >= size())
+		throw std::out_of_range("Argument handle out of range.");
+
+	return sources[id];
+}
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "ParserPlan.h"
+#include "ParseError.h"
+#include "MappedFile.h"
+
+/**
+	@brief
+	View of the content of an argument.
+	Depending on ContentMode it refers either to the storage of the parse result or directly to the passed argv.
+*/
+using Content = std::string_view;
+
+/**
+	@brief Source of the value of an argument.
+*/
+enum class ValueSource : std::uint8_t {
+	none = 0,    ///< the argument is not present.
+	commandLine, ///< passed on the command line.
+	configFile,  ///< read from a configuration file (see ConfigFile).
+	environment  ///< read from the environment variable of the argument (see Argument::setEnv()).
+};
+
+/**
+	@brief
+	Contiguous range of the content values of an argument, in the order of the passed arguments.
+	The range views the storage of the parse result and is valid until the result is parsed again, reset or destroyed.
+*/
+class ValueRange
+{
+
+private:
+
+	const Content* first = nullptr;
+	const Content* last = nullptr;
+
+public:
+
+	using iterator = const Content*;
+
+	ValueRange() = default;
+	ValueRange(const Content* first, const Content* last) noexcept :
+		first(first), last(last) {}
+
+	iterator begin() const noexcept { return first; }
+	iterator end() const noexcept { return last; }
+	const Content* data() const noexcept { return first; }
+	std::size_t size() const noexcept { return static_cast<std::size_t>(last - first); }
+	bool empty() const noexcept { return first == last; }
+	const Content& operator[](std::size_t idx) const noexcept { return first[idx]; }
+};
+
+/**
+	@brief
+	Result of a parse stored as a structure of arrays indexed by ArgId:
+	presence bits, content pointers and lengths, occurrence counts.
+	The arrays are sized once from the plan and reused by the following parses,
+	so the only allocation of a parse is the buffer of the copied content.
+	All storage is allocated from the memory resource passed to the constructor.
+	Each thread must parse into its own result; the plan can be shared.
+*/
+class ParseResult
+{
+
+	// The lazy result reads the typed values of the parses it leaves to the matcher
+	friend class LazyResult;
+
+private:
+
+	std::pmr::memory_resource* resource;
+
+	std::shared_ptr<const ParserPlan> planOwner;
+	const ParserPlan* plan = nullptr;
+
+	std::pmr::vector<std::uint64_t> presence;
+	std::pmr::vector<const char*> valueData;
+	std::pmr::vector<std::uint32_t> valueSize;
+	std::pmr::vector<std::uint32_t> occurrences;
+	std::pmr::vector<ValueSource> sources;
+
+	// Content values of all occurrences, grouped by argument after the parse: values of id are [valueBegin[id], valueBegin[id + 1])
+	std::pmr::vector<Content> values;
+	std::pmr::vector<ArgId> valueOwners;
+	std::pmr::vector<std::uint32_t> valueBegin;
+	std::pmr::vector<Content> groupedValues;
+
+	// Converted values of the typed arguments, parallel to values
+	std::pmr::vector<TypedValue> typedValues;
+	std::pmr::vector<TypedValue> groupedTypedValues;
+
+	// Errors collected by ParserPlan::tryParseAll()
+	std::pmr::vector<ParseError> parseErrors;
+
+	// Checksums of the content, filled in debug builds only
+	std::pmr::vector<std::size_t> checksums;
+
+	// Never reallocated once filled, so the content pointers survive moves of the result
+	std::pmr::vector<char> contentStorage;
+
+	// Response files viewed by the content
+	std::pmr::vector<MappedFile> files;
+
+	// Blocks of the values copied by storeValue(), never reallocated
+	std::pmr::vector<std::pmr::vector<char>> storedBlocks;
+	char* storedNext = nullptr;
+	std::size_t storedFree = 0;
+
+#ifdef ARGSMANAGER_STATS
+	// Counters of the last parse
+	ParseStats parseStats;
+#endif
+
+	void checkParsed() const;
+	void releaseStored() noexcept;
+	const TypedValue& typedValue(ArgId id, std::size_t idx, ValueType type) const;
+
+	// Counts an allocation if the vector has to grow to the size
+	template<typename Vector>
+	void countGrowth(const Vector& vector, std::size_t size) noexcept
+	{
+#ifdef ARGSMANAGER_STATS
+		if (size > vector.capacity())
+			++parseStats.allocations;
+#else
+		(void)vector;
+		(void)size;
+#endif
+	}
+
+public:
+
+	/**
+		@brief constructor, the storage is allocated from the default memory resource.
+	*/
+	ParseResult();
+
+	/**
+		@brief constructor.
+		@param resource memory resource of all storage of the result, must outlive the result.
+		With a std::pmr::monotonic_buffer_resource the whole parse is released in one shot,
+		with a buffer on the stack the parse does not allocate from the heap.
+	*/
+	explicit ParseResult(std::pmr::memory_resource* resource);
+
+	ParseResult(ParseResult&&) noexcept = default;
+
+	/**
+		@brief Move semantics operator=, the result keeps its memory resource.
+		If the resources differ, the content is copied into the storage of this result,
+		the views of ContentMode::view become copies.
+		@throw If the resources differ and the storage cannot be allocated, then both results are reset.
+	*/
+	ParseResult& operator=(ParseResult&& other);
+	ParseResult(const ParseResult&) = delete;
+	ParseResult& operator=(const ParseResult&) = delete;
+
+	/**
+		@brief Clears the result and sizes it for the arguments of the plan.
+		Memory is reused if the result already has the required size.
+		The plan is kept alive by the result if it is owned by a shared_ptr, otherwise it must outlive the result.
+		@param plan plan of the following parse.
+	*/
+	void reset(const ParserPlan& plan);
+
+	/**
+		@brief Clears the result, it becomes unparsed.
+	*/
+	void reset();
+
+	/**
+		@brief Records an occurrence of the argument. The content of the first occurrence is kept.
+		@return TRUE if it is the first occurrence of the argument, otherwise FALSE.
+		@param id handle of the argument.
+		@param content content of the argument, may be empty.
+		@param source source of the argument, recorded by its first occurrence.
+	*/
+	bool add(ArgId id, Content content, ValueSource source = ValueSource::commandLine);
+
+	/**
+		@brief Records a content value of the argument, after its occurrence was recorded by add().
+		The first value is also the content returned by argValue().
+		@param id handle of the argument.
+		@param content content value.
+		@param typed value converted to the type of the argument.
+	*/
+	void addValue(ArgId id, Content content, const TypedValue& typed = TypedValue());
+
+	/**
+		@brief Records an error of the parse.
+		@param error error found by the parse.
+	*/
+	void addError(const ParseError& error);
+
+	/**
+		@brief Returns the errors recorded by the last parse, in the order they were found.
+	*/
+	const std::pmr::vector<ParseError>& errors() const noexcept;
+
+	/**
+		@brief Returns the counters of the last parse, zero unless the library is built with ARGSMANAGER_STATS.
+		The counters are cleared by reset(const ParserPlan&) at the start of a parse.
+	*/
+	const ParseStats& stats() const noexcept;
+
+#ifdef ARGSMANAGER_STATS
+	/**
+		@brief Returns the counters of the last parse, updated by the parsers of this library.
+	*/
+	ParseStats& stats() noexcept;
+#endif
+
+	/**
+		@brief Copies the value into storage owned by the result, for tokens which do not outlive the parse.
+		@return View of the copy, valid until the result is reset or destroyed.
+		@param value content value.
+	*/
+	Content storeValue(Content value);
+
+	/**
+		@brief Groups the recorded content values by argument, must be called once after the last addValue().
+	*/
+	void groupValues();
+
+	/**
+		@brief Keeps the mapped response file alive as long as the content may view it.
+		@param file mapped response file.
+	*/
+	void keepFile(MappedFile&& file);
+
+	/**
+		@brief Copies the content of all arguments into one buffer owned by the result, after groupValues().
+		The kept response files and the stored values are released.
+	*/
+	void copyContent();
+
+	/**
+		@brief Stores the checksums of the content to detect modifications of argv (debug builds only).
+	*/
+	void sealContent();
+
+	/**
+		@brief Returns TRUE if the result was filled by a parse, otherwise FALSE.
+	*/
+	bool parsed() const noexcept;
+
+	/**
+		@brief Returns the plan of the parse or nullptr if the result was not parsed.
+	*/
+	const ParserPlan* getPlan() const noexcept;
+
+	/**
+		@brief Returns the memory resource of the storage.
+	*/
+	std::pmr::memory_resource* getResource() const noexcept;
+
+	/**
+		@brief Returns the count of arguments the result was sized for.
+	*/
+	std::uint32_t size() const noexcept;
+
+	/**
+		@brief Returns the presence bitmask, one bit per argument.
+	*/
+	const std::pmr::vector<std::uint64_t>& presenceMask() const noexcept;
+
+	/**
+		@brief Extract content of the argument.
+		@return View of the content for the specified argument, no copy is made. See ContentMode for its lifetime.
+		@throw arg Not found, has no content or the result was not parsed.
+		@param arg argument for which the content should be retrieved.
+	*/
+	Content argValue(const Argument& arg) const;
+
+	/**
+		@brief Extract content of the argument with the specified handle.
+		@return View of the content for the specified argument, no copy is made. See ContentMode for its lifetime.
+		@throw id is out of range, argument not found, has no content or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	Content argValue(ArgId id) const;
+
+	/**
+		@brief Returns all content values of the argument: every value of a repeatable argument or of an argument with arity.
+		@return Range of the values, empty if the argument is not present. See ContentMode for the lifetime of the values.
+		@throw arg Not found, has no content or the result was not parsed.
+		@param arg argument for which the values should be retrieved.
+	*/
+	ValueRange argValues(const Argument& arg) const;
+
+	/**
+		@brief Returns all content values of the argument with the specified handle.
+		@return Range of the values, empty if the argument is not present. See ContentMode for the lifetime of the values.
+		@throw id is out of range, the argument has no content or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	ValueRange argValues(ArgId id) const;
+
+	/**
+		@brief Returns the value of the argument of type ValueType::integer, converted while parsing.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or the result was not parsed.
+		@param id handle of the argument.
+		@param idx index of the value in argValues().
+	*/
+	std::int64_t argInt(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the value of the argument of type ValueType::floating, converted while parsing.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or the result was not parsed.
+		@param id handle of the argument.
+		@param idx index of the value in argValues().
+	*/
+	double argFloat(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the value of the argument of type ValueType::boolean, converted while parsing.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or the result was not parsed.
+		@param id handle of the argument.
+		@param idx index of the value in argValues().
+	*/
+	bool argBool(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the count of bytes of the argument of type ValueType::byteSize, converted while parsing.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or the result was not parsed.
+		@param id handle of the argument.
+		@param idx index of the value in argValues().
+	*/
+	std::uint64_t argBytes(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the duration of the argument of type ValueType::duration, converted while parsing.
+		@throw id is out of range, argument not found, the type differs, idx is out of range or the result was not parsed.
+		@param id handle of the argument.
+		@param idx index of the value in argValues().
+	*/
+	std::chrono::nanoseconds argDuration(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Returns the index of the choice of the argument of type ValueType::choice (see Argument::setChoices()).
+		@throw id is out of range, argument not found, the type differs, idx is out of range or the result was not parsed.
+		@param id handle of the argument.
+		@param idx index of the value in argValues().
+	*/
+	std::size_t argChoice(ArgId id, std::size_t idx = 0) const;
+
+	/**
+		@brief Checks if the argument is present in the passed arguments.
+		@return True if arguemnt is present in the passed arguments, otherwise false.
+		@throw If the result was not parsed.
+		@param arg Argument.
+	*/
+	bool argPresent(const Argument& arg) const;
+
+	/**
+		@brief Checks if the argument with the specified handle is present in the passed arguments.
+		@return True if arguemnt is present in the passed arguments, otherwise false.
+		@throw If id is out of range or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	bool argPresent(ArgId id) const;
+
+	/**
+		@brief Returns how many times the argument with the specified handle is present in the passed arguments.
+		@return Count of occurrences, 0 if the argument is not present.
+		@throw If id is out of range or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	std::uint32_t argOccurrences(ArgId id) const;
+
+	/**
+		@brief Returns the source of the argument with the specified handle.
+		@return Source of the argument, ValueSource::none if the argument is not present.
+		@throw If id is out of range or the result was not parsed.
+		@param id handle of the argument.
+	*/
+	ValueSource argSource(ArgId id) const;
+};
@@ -0,0 +1,66 @@
+#include "ArgsManager.h"
+
+namespace {
+
+	// Visits the counters in the order of CumulativeStats: the fields, the phases, the errors
+	template<typename Stats, typename Function>
+	void forEachCounter(Stats& stats, Function&& function)
+	{
+		std::size_t idx = 0;
+
+		for (auto* field : { &stats.parses, &stats.tokens, &stats.lookups,
+			&stats.nameComparisons, &stats.allocations, &stats.bytesCopied })
+			function(idx++, *field);
+
+		for (auto& value : stats.phaseNanos)
+			function(idx++, value);
+
+		for (auto& value : stats.errors)
+			function(idx++, value);
+	}
+
+}
+
+static_assert(static_cast<std::size_t>(ParseErrc::outOfMemory) < ParseStats::errorKinds,
+	"ParseStats::errorKinds must cover all error codes");
+
+ParseStats& ParseStats::operator+=(const ParseStats& other) noexcept
+{
+	parses += other.parses;
+	tokens += other.tokens;
+	lookups += other.lookups;
+	nameComparisons += other.nameComparisons;
+	allocations += other.allocations;
+	bytesCopied += other.bytesCopied;
+
+	for (std::size_t idx = 0; idx < phaseCount; ++idx)
+		phaseNanos[idx] += other.phaseNanos[idx];
+
+	for (std::size_t idx = 0; idx < errorKinds; ++idx)
+		errors[idx] += other.errors[idx];
+
+	return *this;
+}
+
+void CumulativeStats::add(const ParseStats& stats) noexcept
+{
+	forEachCounter(stats, [this](std::size_t idx, std::uint64_t value) {
+		if (value != 0)
+			counters[idx].fetch_add(value, std::memory_order_relaxed);
+	});
+}
+
+ParseStats CumulativeStats::snapshot() const noexcept
+{
+	ParseStats stats;
+	forEachCounter(stats, [this](std::size_t idx, std::uint64_t& value) {
+		value = counters[idx].load(std::memory_order_relaxed);
+	});
+	return stats;
+}
+
+void CumulativeStats::clear() noexcept
+{
+	for (auto& counter : counters)
+		counter.store(0, std::memory_order_relaxed);
+}
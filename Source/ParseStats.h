@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class ParseErrc : std::uint8_t;
+
+/**
+	@brief Phases of a parse measured by ParseStats.
+*/
+enum class ParsePhase : std::uint8_t {
+	match,       ///< tokens matched against the name index, the typed values are converted.
+	content,     ///< values grouped by argument and copied into the result.
+	required,    ///< check of the required arguments.
+	requiredSet  ///< check of the required set.
+};
+
+/**
+	@brief
+	Counters of the parses, collected only when the library is built with ARGSMANAGER_STATS
+	(CMake option of the same name); otherwise the counters stay zero and the parse pays nothing for them.
+	A ParseResult holds the counters of its last parse, a ParserPlan the sum of all parses against it.
+*/
+struct ParseStats {
+#ifdef ARGSMANAGER_STATS
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	static constexpr std::size_t phaseCount = 4;
+	static constexpr std::size_t errorKinds = 32;
+
+	std::uint64_t parses = 0;          ///< count of parses.
+	std::uint64_t tokens = 0;          ///< tokens scanned, including the tokens of the response files.
+	std::uint64_t lookups = 0;         ///< probes of the name index.
+	std::uint64_t nameComparisons = 0; ///< names compared by the probes.
+	std::uint64_t allocations = 0;     ///< growths of the storage of the result.
+	std::uint64_t bytesCopied = 0;     ///< bytes of the content copied into the result.
+
+	std::array<std::uint64_t, phaseCount> phaseNanos{}; ///< time of each phase, indexed by ParsePhase.
+	std::array<std::uint64_t, errorKinds> errors{};     ///< errors, indexed by ParseErrc.
+
+	/**
+		@brief Returns the time spent in the phase.
+	*/
+	std::chrono::nanoseconds phaseTime(ParsePhase phase) const noexcept
+	{
+		return std::chrono::nanoseconds(phaseNanos[static_cast<std::size_t>(phase)]);
+	}
+
+	/**
+		@brief Returns the count of the errors of the kind.
+	*/
+	std::uint64_t errorCount(ParseErrc code) const noexcept
+	{
+		return errors[static_cast<std::size_t>(code)];
+	}
+
+	ParseStats& operator+=(const ParseStats& other) noexcept;
+};
+
+/**
+	@brief
+	Sum of the counters of many parses, updated and read with relaxed atomics,
+	so any thread can take a snapshot while others are parsing.
+*/
+class CumulativeStats
+{
+
+private:
+
+	static constexpr std::size_t counterCount = 6 + ParseStats::phaseCount + ParseStats::errorKinds;
+
+	std::array<std::atomic<std::uint64_t>, counterCount> counters{};
+
+public:
+
+	CumulativeStats() = default;
+	CumulativeStats(const CumulativeStats&) = delete;
+	CumulativeStats& operator=(const CumulativeStats&) = delete;
+
+	/**
+		@brief Adds the counters of a parse.
+	*/
+	void add(const ParseStats& stats) noexcept;
+
+	/**
+		@brief Returns a copy of the counters; the counters of a concurrent parse may be partially included.
+	*/
+	ParseStats snapshot() const noexcept;
+
+	/**
+		@brief Sets all counters to zero.
+	*/
+	void clear() noexcept;
+};
+
+#ifdef ARGSMANAGER_STATS
+/**
+	@brief Equality of the names of the index, counts the comparisons made by the calling thread.
+*/
+struct CountingNameEqual {
+	static inline thread_local std::uint64_t comparisons = 0;
+
+	bool operator()(std::string_view left, std::string_view right) const noexcept
+	{
+		++comparisons;
+		return left == right;
+	}
+};
+#endif
@@ -0,0 +1,855 @@
+#include "ArgsManager.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#else
+extern char** environ;
+#endif
+
+namespace {
+
+	// Levenshtein distance, a metric as required by the BK-tree
+	std::uint32_t editDistance(std::string_view left, std::string_view right)
+	{
+		if (left.size() < right.size())
+			std::swap(left, right);
+
+		// One row of the matrix, over the shorter string
+		std::uint32_t small[64];
+		std::vector<std::uint32_t> large;
+		std::uint32_t* row = small;
+		if (right.size() + 1 > sizeof(small) / sizeof(small[0])) {
+			large.resize(right.size() + 1);
+			row = large.data();
+		}
+
+		for (std::size_t col = 0; col <= right.size(); ++col)
+			row[col] = static_cast<std::uint32_t>(col);
+
+		for (std::size_t line = 1; line <= left.size(); ++line) {
+			std::uint32_t diagonal = row[0];
+			row[0] = static_cast<std::uint32_t>(line);
+
+			for (std::size_t col = 1; col <= right.size(); ++col) {
+				const std::uint32_t above = row[col];
+				const std::uint32_t substitution = diagonal + (left[line - 1] != right[col - 1]);
+				row[col] = std::min({ above + 1, row[col - 1] + 1, substitution });
+				diagonal = above;
+			}
+		}
+
+		return row[right.size()];
+	}
+
+	bool isResponseFile(std::string_view token)
+	{
+		return token.size() > 1 && token[0] == '@';
+	}
+
+	// Replaces the tokens @path by the tokens of the response files, the files are tokenized lazily in place
+	class ResponseFiles
+	{
+
+	private:
+
+		struct OpenFile {
+			std::filesystem::path path;
+			Tokenizer tokenizer;
+		};
+
+		ParseResult& result;
+
+		// Stack of the nested files being tokenized, used to detect the cycles
+		std::vector<OpenFile> openFiles;
+
+		ParseError open(std::string_view token, std::uint32_t idx)
+		{
+			std::filesystem::path path(std::string(token.substr(1)));
+			if (path.is_relative() && !openFiles.empty())
+				path = openFiles.back().path.parent_path() / path;
+
+			std::error_code errorCode;
+			std::filesystem::path canonical = std::filesystem::weakly_canonical(path, errorCode);
+			if (!errorCode)
+				path = std::move(canonical);
+
+			for (const auto& file : openFiles) {
+				if (file.path == path)
+					return { ParseErrc::responseFileCycle, idx };
+			}
+
+			MappedFile file;
+			if (!file.open(path.string().c_str()))
+				return { ParseErrc::responseFileNotRead, idx };
+
+			// The mapped address does not change when the file is moved into the result
+			openFiles.push_back({ std::move(path), Tokenizer(file.begin(), file.size()) });
+			result.keepFile(std::move(file));
+			return {};
+		}
+
+	public:
+
+		explicit ResponseFiles(ParseResult& result) :
+			result(result) {}
+
+		// Matches the tokens of the response file named by the token, the errors refer to the token idx.
+		// collect receives the errors met in the file, NULL to stop at the first one
+		ParseError expand(Matcher& matcher, std::string_view token, std::uint32_t idx, ParseResult* collect);
+	};
+
+	// Tokens classified in bulk by TokenClassifier, then passed to the matcher in order
+	class TokenBatch
+	{
+
+	public:
+
+		static constexpr std::size_t capacity = 64;
+
+	private:
+
+		std::string_view tokens[capacity];
+		std::uint32_t indexes[capacity];
+		TokenKind kinds[capacity];
+		std::uint32_t splits[capacity];
+		std::size_t count = 0;
+
+	public:
+
+		bool full() const noexcept
+		{
+			return count == capacity;
+		}
+
+		void push(std::string_view token, std::uint32_t idx) noexcept
+		{
+			tokens[count] = token;
+			indexes[count] = idx;
+			++count;
+		}
+
+		// Matches the tokens, stops at the first error unless the errors are collected into the result
+		ParseError match(Matcher& matcher, ParseResult* collect)
+		{
+			const std::size_t size = count;
+			count = 0;
+
+			TokenClassifier::classify(tokens, size, kinds, splits);
+
+			for (std::size_t idx = 0; idx < size; ++idx) {
+				const ParseError error = matcher.token(tokens[idx], kinds[idx], splits[idx], indexes[idx]);
+				if (!error)
+					continue;
+
+				if (collect == nullptr)
+					return error;
+				collect->addError(error);
+			}
+
+			return {};
+		}
+	};
+
+	ParseError ResponseFiles::expand(Matcher& matcher, std::string_view token, std::uint32_t idx, ParseResult* collect)
+	{
+		TokenBatch batch;
+		ParseError error = open(token, idx);
+
+		while (!error && !openFiles.empty()) {
+			Tokenizer& tokenizer = openFiles.back().tokenizer;
+			std::string_view fileToken;
+
+			if (tokenizer.next(fileToken)) {
+				if (isResponseFile(fileToken)) {
+					error = batch.match(matcher, collect);
+					if (!error && matcher.optionsEnded())
+						batch.push(fileToken, idx);
+					else if (!error)
+						error = open(fileToken, idx);
+				}
+				else {
+					batch.push(fileToken, idx);
+					if (batch.full())
+						error = batch.match(matcher, collect);
+				}
+			}
+			else {
+				error = batch.match(matcher, collect);
+				if (!error && tokenizer.unterminatedQuote())
+					error = { ParseErrc::unterminatedQuote, idx };
+				if (!error || collect != nullptr)
+					openFiles.pop_back();
+			}
+
+			// A collected error skips the file not read or the rest of the unterminated one, the parse goes on
+			if (error && collect != nullptr) {
+				collect->addError(error);
+				error = {};
+			}
+		}
+
+		openFiles.clear();
+		return error;
+	}
+
+	// Stream of the tokens of a parse: batches the tokens and expands the response files
+	class TokenStream
+	{
+
+	private:
+
+		Matcher& matcher;
+		ResponseFiles responseFiles;
+		bool expandFiles;
+		ParseResult* collect;
+		TokenBatch batch;
+
+	public:
+
+		// collect receives all errors, NULL to stop at the first one
+		TokenStream(Matcher& matcher, ParseResult& result, bool expandFiles, ParseResult* collect) :
+			matcher(matcher), responseFiles(result), expandFiles(expandFiles), collect(collect) {}
+
+		ParseError push(std::string_view token, std::uint32_t idx)
+		{
+			if (expandFiles && isResponseFile(token)) {
+				ParseError error = flush();
+
+				// After "--" the token is an operand, the file is not read
+				if (!error && matcher.optionsEnded()) {
+					batch.push(token, idx);
+					return batch.full() ? flush() : ParseError();
+				}
+
+				if (!error)
+					error = responseFiles.expand(matcher, token, idx, collect);
+
+				if (error && collect != nullptr) {
+					collect->addError(error);
+					return {};
+				}
+				return error;
+			}
+
+			batch.push(token, idx);
+			return batch.full() ? flush() : ParseError();
+		}
+
+		ParseError flush()
+		{
+			return batch.match(matcher, collect);
+		}
+	};
+
+}
+
+bool ParserPlan::isContent(std::string_view token) noexcept
+{
+	return !token.empty() && token[0] != '-';
+}
+
+bool ParserPlan::isNegativeNumber(std::string_view token, ValueType type) noexcept
+{
+	if (type != ValueType::integer && type != ValueType::floating && type != ValueType::duration)
+		return false;
+
+	return token.size() > 1 && token[0] == '-' && ((token[1] >= '0' && token[1] <= '9') || token[1] == '.');
+}
+
+const char* const* ParserPlan::processEnvironment() noexcept
+{
+#ifdef _WIN32
+	return _environ;
+#else
+	return environ;
+#endif
+}
+
+bool ParserPlan::takesContent(ArgId id, std::string_view token, TokenKind kind) const noexcept
+{
+	if (kind == TokenKind::value)
+		return true;
+
+	return kind == TokenKind::negativeNumber && isNegativeNumber(token, types[id]) && find(token) == npos;
+}
+
+ParserPlan::ParserPlan(std::vector<Argument> arguments, std::vector<std::uint8_t> flags,
+	std::pmr::memory_resource* resource) :
+	arguments(std::make_move_iterator(arguments.begin()), std::make_move_iterator(arguments.end()), resource),
+	flags(flags.begin(), flags.end(), resource),
+	arities(resource), types(resource), requiredMask(resource), requiredSetMask(resource), nameIndex(resource),
+	environmentIndex(resource), configIndex(resource), longNames(resource), nameTree(resource)
+{
+	build();
+}
+
+ParserPlan::ParserPlan(const std::pmr::vector<Argument>& arguments, const std::pmr::vector<std::uint8_t>& flags,
+	std::pmr::memory_resource* resource, const NameTable* nameTable) :
+	arguments(arguments.begin(), arguments.end(), resource),
+	flags(flags.begin(), flags.end(), resource),
+	arities(resource), types(resource), requiredMask(resource), requiredSetMask(resource), nameIndex(resource),
+	nameTable(nameTable), environmentIndex(resource), configIndex(resource), longNames(resource), nameTree(resource)
+{
+	build();
+}
+
+void ParserPlan::build()
+{
+	if (arguments.size() != flags.size())
+		throw std::invalid_argument("Count of flags does not match count of arguments.");
+
+	if (arguments.size() >= npos)
+		throw std::length_error("Too many arguments.");
+
+	requiredMask.assign(wordCount(), 0);
+	requiredSetMask.assign(wordCount(), 0);
+	arities.reserve(arguments.size());
+	types.reserve(arguments.size());
+	if (nameTable == nullptr)
+		nameIndex.reserve(arguments.size() * 2);
+	else if (nameTable->argumentCount != size())
+		throw std::invalid_argument("The name table does not match the arguments.");
+	configIndex.reserve(arguments.size() * 2);
+
+	std::uint32_t nameCount = 0;
+
+	for (ArgId idx = 0; idx < size(); ++idx) {
+		const Argument& arg = arguments[idx];
+
+		arities.push_back(arg.getArity());
+		types.push_back(arg.getType());
+		if (arg.isRepeatable())
+			flags[idx] |= repeatable;
+
+		addName(arg.getArg1(), idx);
+		++nameCount;
+		if (!arg.getArg2().empty() && arg.getArg2() != arg.getArg1()) {
+			addName(arg.getArg2(), idx);
+			++nameCount;
+		}
+		if (!arg.getEnv().empty())
+			addEnvironment(arg, idx);
+
+		const std::uint64_t bit = std::uint64_t(1) << (idx % wordBits);
+
+		if (flags[idx] & required) {
+			requiredMask[idx / wordBits] |= bit;
+			hasRequired = true;
+		}
+
+		if (flags[idx] & requiredSet) {
+			requiredSetMask[idx / wordBits] |= bit;
+			hasRequiredSet = true;
+		}
+	}
+
+	if (nameTable != nullptr && nameTable->slotCount != nameCount)
+		throw std::invalid_argument("The name table does not match the arguments.");
+}
+
+void ParserPlan::addName(const std::string& name, ArgId id)
+{
+	if (nameTable != nullptr) {
+		if (nameTable->find(name) != id)
+			throw std::invalid_argument("The name table does not match the arguments.");
+	}
+	else {
+		// Keys are views into the arguments owned by the plan, which are never reallocated
+		const auto inserted = nameIndex.emplace(name, id);
+		if (!inserted.second && inserted.first->second != id)
+			throw std::runtime_error("This argument has already been added");
+	}
+
+	// Names differing only by their dashes (-v and --v) share a key, the first registered is set
+	const std::size_t dashes = name.find_first_not_of('-');
+	if (dashes != std::string::npos)
+		configIndex.emplace(std::string_view(name).substr(dashes), id);
+}
+
+void ParserPlan::addEnvironment(const Argument& arg, ArgId id)
+{
+	if (arg.getArity() > 1 && arg.getArity() != Argument::variadic)
+		throw std::invalid_argument("Argument " + arg.quotedNames() + " takes more than one value from the environment.");
+
+	if (!environmentIndex.emplace(arg.getEnv(), id).second)
+		throw std::runtime_error("This environment variable has already been added");
+}
+
+void ParserPlan::buildNearIndex() const
+{
+	std::call_once(nearIndexOnce, [this]() {
+		for (ArgId id = 0; id < size(); ++id) {
+			for (const std::string* name : { &arguments[id].getArg1(), &arguments[id].getArg2() }) {
+				if (name->size() > 2 && name->compare(0, 2, "--") == 0)
+					longNames.emplace_back(*name, id);
+			}
+		}
+		std::sort(longNames.begin(), longNames.end());
+		longNames.erase(std::unique(longNames.begin(), longNames.end()), longNames.end());
+
+		// Insertion in the order of registration, so the tree is the same for every plan of the arguments
+		nameTree.reserve(std::size_t(size()) * 2);
+		for (ArgId id = 0; id < size(); ++id) {
+			for (const std::string* name : { &arguments[id].getArg1(), &arguments[id].getArg2() }) {
+				if (name->empty())
+					continue;
+
+				nameTree.push_back({ *name, id, 0, 0, 0 });
+				const std::uint32_t added = static_cast<std::uint32_t>(nameTree.size() - 1);
+
+				for (std::uint32_t node = 0; added != 0;) {
+					const std::uint32_t distance = editDistance(nameTree[node].name, *name);
+					if (distance == 0)
+						break;
+
+					std::uint32_t child = nameTree[node].firstChild;
+					while (child != 0 && nameTree[child].distance != distance)
+						child = nameTree[child].nextSibling;
+
+					if (child == 0) {
+						nameTree[added].distance = distance;
+						nameTree[added].nextSibling = nameTree[node].firstChild;
+						nameTree[node].firstChild = added;
+						break;
+					}
+					node = child;
+				}
+			}
+		}
+	});
+}
+
+std::uint32_t ParserPlan::size() const noexcept
+{
+	return static_cast<std::uint32_t>(arguments.size());
+}
+
+std::size_t ParserPlan::wordCount() const noexcept
+{
+	return (arguments.size() + wordBits - 1) / wordBits;
+}
+
+const Argument& ParserPlan::argument(ArgId id) const
+{
+	return arguments.at(id);
+}
+
+std::uint8_t ParserPlan::argumentFlags(ArgId id) const
+{
+	return flags.at(id);
+}
+
+std::uint32_t ParserPlan::argumentArity(ArgId id) const
+{
+	return arities.at(id);
+}
+
+ValueType ParserPlan::argumentType(ArgId id) const
+{
+	return types.at(id);
+}
+
+ArgId ParserPlan::find(std::string_view name) const noexcept
+{
+	if (nameTable != nullptr)
+		return nameTable->find(name);
+
+	const auto found = nameIndex.find(name);
+	return (found != nameIndex.end()) ? found->second : npos;
+}
+
+ArgId ParserPlan::findEnvironment(std::string_view name) const noexcept
+{
+	const auto found = environmentIndex.find(name);
+	return (found != environmentIndex.end()) ? found->second : npos;
+}
+
+std::uint32_t ParserPlan::environmentCount() const noexcept
+{
+	return static_cast<std::uint32_t>(environmentIndex.size());
+}
+
+ArgId ParserPlan::findAbbreviation(std::string_view prefix, bool& ambiguous) const
+{
+	buildNearIndex();
+	ambiguous = false;
+
+	ArgId found = npos;
+	auto name = std::lower_bound(longNames.begin(), longNames.end(), prefix,
+		[](const std::pair<std::string_view, ArgId>& entry, std::string_view value) { return entry.first < value; });
+
+	for (; name != longNames.end() && name->first.compare(0, prefix.size(), prefix) == 0; ++name) {
+		if (found != npos && found != name->second) {
+			ambiguous = true;
+			return npos;
+		}
+		found = name->second;
+	}
+
+	return found;
+}
+
+std::vector<ArgId> ParserPlan::suggest(std::string_view token, std::size_t count) const
+{
+	buildNearIndex();
+
+	const std::uint32_t limit = (token.size() <= 4) ? 1 : 2;
+	std::vector<std::pair<std::uint32_t, ArgId>> near;
+
+	// Depth-first search, a child at the distance d from its node can only be near if |d - distance(node)| <= limit
+	std::vector<std::uint32_t> stack;
+	if (!nameTree.empty())
+		stack.push_back(0);
+
+	while (!stack.empty()) {
+		const NameNode& node = nameTree[stack.back()];
+		stack.pop_back();
+
+		const std::uint32_t distance = editDistance(node.name, token);
+		if (distance <= limit)
+			near.emplace_back(distance, node.id);
+
+		for (std::uint32_t child = node.firstChild; child != 0; child = nameTree[child].nextSibling) {
+			if (nameTree[child].distance + limit >= distance && nameTree[child].distance <= distance + limit)
+				stack.push_back(child);
+		}
+	}
+
+	std::sort(near.begin(), near.end());
+
+	std::vector<ArgId> ids;
+	for (const auto& entry : near) {
+		if (ids.size() == count)
+			break;
+		if (std::find(ids.begin(), ids.end(), entry.second) == ids.end())
+			ids.push_back(entry.second);
+	}
+	return ids;
+}
+
+ArgId ParserPlan::findConfigKey(std::string_view key) const noexcept
+{
+	const auto found = configIndex.find(key);
+	return (found != configIndex.end()) ? found->second : npos;
+}
+
+ArgId ParserPlan::indexOf(const Argument& arg) const noexcept
+{
+	const ArgId idx = find(std::string_view(arg.getArg1()));
+	if (idx != npos || arg.getArg2().empty())
+		return idx;
+	return find(std::string_view(arg.getArg2()));
+}
+
+const std::pmr::vector<std::uint64_t>& ParserPlan::getRequiredMask() const noexcept
+{
+	return requiredMask;
+}
+
+const std::pmr::vector<std::uint64_t>& ParserPlan::getRequiredSetMask() const noexcept
+{
+	return requiredSetMask;
+}
+
+bool ParserPlan::requiresArgs() const noexcept
+{
+	return hasRequired;
+}
+
+bool ParserPlan::requiresSet() const noexcept
+{
+	return hasRequiredSet;
+}
+
+void ParserPlan::parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+	ParseResult& result, ParseOptions options) const
+{
+	const ParseError error = tryParse(argc, argv, beginIdx, result, options);
+	if (error)
+		throwError(error, options);
+}
+
+ParseResult ParserPlan::parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+	ParseOptions options) const
+{
+	ParseResult result;
+	parse(argc, argv, beginIdx, result, options);
+	return result;
+}
+
+ParseError ParserPlan::tryParse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+	ParseResult& result, ParseOptions options) const
+{
+	const ParseError error = matchArgv(argc, argv, beginIdx, result, options);
+	recordStats(result, error);
+	return error;
+}
+
+ParseError ParserPlan::matchArgv(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+	ParseResult& result, ParseOptions options) const
+{
+	if (argc == 0 && (requiresArgs() || requiresSet()))
+		return { ParseErrc::noArguments };
+
+	if (argc > 0 && argv == nullptr)
+		return { ParseErrc::nullArgv };
+
+	if (beginIdx > argc)
+		return { ParseErrc::beginOutOfRange };
+
+	Matcher matcher(*this, result, false, options.strict, options.optionsTerminator);
+	TokenStream stream(matcher, result, options.responseFiles, nullptr);
+
+	for (unsigned int idx = beginIdx; idx < argc; ++idx) {
+		const char* const paramStr = argv[idx];
+
+		if (paramStr == nullptr) {
+			const ParseError error = stream.flush();
+			if (error)
+				return error;
+
+			// NULL pointer in place of the content is reported as missing content
+			if (matcher.expectsContent())
+				return matcher.token(std::string_view(), idx);
+			return { ParseErrc::nullArgument, idx };
+		}
+
+		const ParseError error = stream.push(paramStr, idx);
+		if (error)
+			return error;
+	}
+
+	const ParseError error = stream.flush();
+	if (error)
+		return error;
+
+	return matcher.finish(options);
+}
+
+ParseOutcome ParserPlan::tryParseAll(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+	ParseResult& result, ParseOptions options) const noexcept
+{
+	try {
+		ParseError fatal;
+
+		if (argc == 0 && (requiresArgs() || requiresSet()))
+			fatal = { ParseErrc::noArguments };
+		else if (argc > 0 && argv == nullptr)
+			fatal = { ParseErrc::nullArgv };
+		else if (beginIdx > argc)
+			fatal = { ParseErrc::beginOutOfRange };
+
+		if (fatal) {
+			recordStats(result, fatal);
+			return ParseOutcome(this, result, fatal);
+		}
+
+		Matcher matcher(*this, result, false, options.strict, options.optionsTerminator);
+		TokenStream stream(matcher, result, options.responseFiles, &result);
+
+		for (unsigned int idx = beginIdx; idx < argc; ++idx) {
+			const char* const paramStr = argv[idx];
+
+			if (paramStr == nullptr) {
+				stream.flush();
+
+				const ParseError error = matcher.expectsContent() ?
+					matcher.token(std::string_view(), idx) : ParseError{ ParseErrc::nullArgument, idx };
+				if (error)
+					result.addError(error);
+				continue;
+			}
+
+			stream.push(paramStr, idx);
+		}
+
+		stream.flush();
+		matcher.finish(options, true);
+
+#ifdef ARGSMANAGER_STATS
+		for (const ParseError& error : result.errors())
+			++result.stats().errors[static_cast<std::size_t>(error.code)];
+#endif
+		recordStats(result, ParseError());
+		return ParseOutcome(this, result, ParseError(), options);
+	}
+	catch (...) {
+		result.reset();
+		recordStats(result, { ParseErrc::outOfMemory });
+		return ParseOutcome(this, result, { ParseErrc::outOfMemory });
+	}
+}
+
+void ParserPlan::parseCommandLine(char* commandLine, std::size_t size,
+	ParseResult& result, ParseOptions options) const
+{
+	const ParseError error = tryParseCommandLine(commandLine, size, result, options);
+	if (error)
+		throwError(error, options);
+}
+
+void ParserPlan::parseCommandLine(std::string& commandLine, ParseResult& result, ParseOptions options) const
+{
+	parseCommandLine(commandLine.data(), commandLine.size(), result, options);
+}
+
+ParseError ParserPlan::tryParseCommandLine(char* commandLine, std::size_t size,
+	ParseResult& result, ParseOptions options) const
+{
+	const ParseError error = matchCommandLine(commandLine, size, result, options);
+	recordStats(result, error);
+	return error;
+}
+
+ParseError ParserPlan::matchCommandLine(char* commandLine, std::size_t size,
+	ParseResult& result, ParseOptions options) const
+{
+	if (commandLine == nullptr && size > 0)
+		return { ParseErrc::nullArgv };
+
+	Matcher matcher(*this, result, false, options.strict, options.optionsTerminator);
+	TokenStream stream(matcher, result, options.responseFiles, nullptr);
+	Tokenizer tokenizer(commandLine, size);
+
+	std::string_view token;
+	std::uint32_t idx = 0;
+
+	while (tokenizer.next(token)) {
+		const ParseError error = stream.push(token, idx);
+		++idx;
+		if (error)
+			return error;
+	}
+
+	const ParseError error = stream.flush();
+	if (error)
+		return error;
+
+	if (tokenizer.unterminatedQuote())
+		return { ParseErrc::unterminatedQuote, idx };
+
+	return matcher.finish(options);
+}
+
+#ifdef ARGSMANAGER_STATS
+void ParserPlan::recordStats(ParseResult& result, const ParseError& error) const noexcept
+{
+	// The result is not reset before the parameters of the call are validated, it keeps the previous parse
+	const bool matched = error.code != ParseErrc::noArguments && error.code != ParseErrc::nullArgv
+		&& error.code != ParseErrc::beginOutOfRange;
+
+	ParseStats rejected;
+	ParseStats& stats = matched ? result.stats() : rejected;
+
+	stats.parses = 1;
+	if (error)
+		++stats.errors[static_cast<std::size_t>(error.code)];
+
+	cumulative.add(stats);
+}
+#endif
+
+ParseStats ParserPlan::cumulativeStats() const noexcept
+{
+#ifdef ARGSMANAGER_STATS
+	return cumulative.snapshot();
+#else
+	return ParseStats();
+#endif
+}
+
+void ParserPlan::clearStats() const noexcept
+{
+#ifdef ARGSMANAGER_STATS
+	cumulative.clear();
+#endif
+}
+
+std::string ParserPlan::errorMessage(const ParseError& error, const ParseOptions& options) const
+{
+	switch (error.code) {
+	case ParseErrc::none:
+		return std::string();
+	case ParseErrc::noArguments:
+		return "Does not pass a list of arguments.";
+	case ParseErrc::nullArgv:
+		return "Pointer argv is NULL!";
+	case ParseErrc::beginOutOfRange:
+		return "Start index out of bounds.";
+	case ParseErrc::nullArgument:
+		return "Argument " + std::to_string(std::size_t(error.token) + 1) + " is NULL";
+	case ParseErrc::missingContent:
+		return "Argument " + argument(error.arg).quotedNames() + " not found!";
+	case ParseErrc::missingRequired:
+		return "Parameter " + argument(error.arg).quotedNames() + " not found!";
+	case ParseErrc::missingRequiredFromSet:
+		return "Required argument not found.";
+	case ParseErrc::unterminatedQuote:
+		return "Argument " + std::to_string(std::size_t(error.token) + 1) + " has an unterminated quote.";
+	case ParseErrc::responseFileNotRead:
+		return "Response file of argument " + std::to_string(std::size_t(error.token) + 1) + " cannot be read.";
+	case ParseErrc::invalidValue: {
+		std::string message = "Argument " + std::to_string(std::size_t(error.token) + 1) + " is not a valid value of "
+			+ argument(error.arg).quotedNames() + ".";
+
+		const auto& choices = argument(error.arg).getChoices();
+		if (argumentType(error.arg) == ValueType::choice && !choices.empty()) {
+			message += " Expected: ";
+			for (std::size_t idx = 0; idx < choices.size(); ++idx)
+				message += ((idx != 0) ? " / '" : "'") + choices[idx] + "'";
+			message += ".";
+		}
+		return message;
+	}
+	case ParseErrc::unexpectedValue:
+		return "Argument " + std::to_string(std::size_t(error.token) + 1) + ": " + argument(error.arg).quotedNames()
+			+ " does not take a value.";
+	case ParseErrc::invalidEnvironment:
+		return "Environment variable '" + argument(error.arg).getEnv() + "' is not a valid value of "
+			+ argument(error.arg).quotedNames() + ".";
+	case ParseErrc::invalidConfigValue: {
+		const std::string file = (error.configFile < options.configCount && options.configFiles != nullptr) ?
+			"'" + options.configFiles[error.configFile].path() + "'" : "a configuration file";
+		return "Line " + std::to_string(std::size_t(error.token) + 1) + " of " + file + " is not a valid value of "
+			+ argument(error.arg).quotedNames() + ".";
+	}
+	case ParseErrc::unknownArgument: {
+		std::string message = "Argument " + std::to_string(std::size_t(error.token) + 1) + " is unknown.";
+		if (error.arg == npos)
+			return message;
+
+		// Did you mean 'a', 'b' or 'c'?
+		message += " Did you mean " + argument(error.arg).quotedNames();
+		for (std::size_t rank = 0; rank < ParseError::maxSuggestions - 1 && error.alternatives[rank] != npos; ++rank) {
+			const bool last = rank + 1 == ParseError::maxSuggestions - 1 || error.alternatives[rank + 1] == npos;
+			message += (last ? " or " : ", ") + argument(error.alternatives[rank]).quotedNames();
+		}
+		return message + "?";
+	}
+	case ParseErrc::ambiguousArgument:
+		return "Argument " + std::to_string(std::size_t(error.token) + 1) + " is an ambiguous abbreviation.";
+	case ParseErrc::outOfMemory:
+		return "Out of memory.";
+	case ParseErrc::responseFileCycle:
+		return "Response file of argument " + std::to_string(std::size_t(error.token) + 1) + " includes itself.";
+	}
+	return "Unknown error.";
+}
+
+void ParserPlan::throwError(const ParseError& error, const ParseOptions& options) const
+{
+	switch (error.code) {
+	case ParseErrc::nullArgv:
+	case ParseErrc::beginOutOfRange:
+		throw std::invalid_argument(errorMessage(error, options));
+	case ParseErrc::nullArgument:
+		throw std::runtime_error(errorMessage(error, options));
+	case ParseErrc::outOfMemory:
+		throw std::bad_alloc();
+	default:
+		throw InvalidArg(errorMessage(error, options));
+	}
+}
@@ -0,0 +1,458 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Argument.h"
+#include "ParseStats.h"
+#include "TokenClassifier.h"
+
+/**
+	@brief Handle of a registered argument, its index in the order of registration.
+*/
+using ArgId = std::uint32_t;
+
+struct NameTable;
+
+/**
+	@brief
+	Storage of the content extracted by the parse.
+*/
+enum class ContentMode {
+	/**
+		Content is copied into a single buffer owned by the parse result (default).
+		The views stay valid until the result is parsed again, reset or destroyed.
+	*/
+	copy,
+	/**
+		Content is not copied, the views point directly into the strings of the passed argv.
+		The strings of argv must stay alive and unchanged while the content is used;
+		in debug builds the parse result checks that the viewed content was not modified.
+	*/
+	view
+};
+
+class ConfigFile;
+
+/**
+	@brief Options of a parse.
+*/
+struct ParseOptions {
+	ContentMode content = ContentMode::copy; ///< storage of the extracted content.
+
+	/**
+		Expand the tokens @path by the tokens of the response file, tokenized by Tokenizer.
+		The file is mapped into memory and tokenized in place while the tokens are matched,
+		response files may include other response files; a relative path is resolved
+		from the directory of the including file. The mapped files are kept by the result
+		with ContentMode::view and released after the copy with ContentMode::copy.
+	*/
+	bool responseFiles = false;
+
+	/**
+		Environment read by the arguments missing from the command line (see Argument::setEnv()):
+		NAME=VALUE strings terminated by NULL, like environ. NULL for the environment of the process.
+		The environment is scanned once per parse and only if an argument of the plan reads a variable.
+	*/
+	const char* const* environment = nullptr;
+
+	/**
+		Configuration files read by the arguments missing from the command line, configCount files in the order
+		of precedence: a later file overrides the earlier ones, the files override the environment.
+		With ContentMode::view the content points into the mapped files, which must outlive the result.
+	*/
+	const ConfigFile* configFiles = nullptr;
+	std::size_t configCount = 0;
+
+	/**
+		Report the tokens starting with '-' which name no argument (ParseErrc::unknownArgument) instead of ignoring them,
+		with the nearest registered names as suggestions. An unambiguous prefix of a name starting with "--"
+		is accepted for that name: --verb for --verbose.
+	*/
+	bool strict = false;
+
+	/**
+		End the options at the token "--" (POSIX): the following tokens are operands, ignored even if they start with '-' or '@'.
+		Off by default: "--" is then matched like the other tokens, as a registered name or ignored.
+	*/
+	bool optionsTerminator = false;
+
+	ParseOptions(ContentMode content = ContentMode::copy, bool responseFiles = false,
+		const char* const* environment = nullptr) noexcept :
+		content(content), responseFiles(responseFiles), environment(environment) {}
+};
+
+class ParseResult;
+struct ParseError;
+class ParseOutcome;
+
+/**
+	@brief
+	Immutable parsing plan compiled from the registered arguments.
+	Holds the name index of all arguments, the requirement bitmasks and the content flags,
+	so any number of parses can be performed against one plan without repeating the setup.
+	Arguments are identified by their handles (ArgId), assigned in the order of registration.
+	The plan is never modified after construction, so it can be shared by any number of threads,
+	each parsing into its own ParseResult.
+*/
+class ParserPlan : public std::enable_shared_from_this<ParserPlan>
+{
+
+public:
+
+	/**
+		@brief Flags describing a registered argument.
+	*/
+	enum Flags : std::uint8_t {
+		required    = 1 << 0,
+		requiredSet = 1 << 1,
+		hasContent  = 1 << 2,
+		repeatable  = 1 << 3
+	};
+
+	static constexpr ArgId npos = ~ArgId(0);
+	static constexpr std::size_t wordBits = 64;
+
+private:
+
+	std::pmr::vector<Argument> arguments;
+	std::pmr::vector<std::uint8_t> flags;
+	std::pmr::vector<std::uint32_t> arities;
+	std::pmr::vector<ValueType> types;
+
+	std::pmr::vector<std::uint64_t> requiredMask;
+	std::pmr::vector<std::uint64_t> requiredSetMask;
+	bool hasRequired = false;
+	bool hasRequiredSet = false;
+
+#ifdef ARGSMANAGER_STATS
+	std::pmr::unordered_map<std::string_view, ArgId, std::hash<std::string_view>, CountingNameEqual> nameIndex;
+
+	// Counters of all parses, the only state of the plan modified after construction
+	mutable CumulativeStats cumulative;
+#else
+	std::pmr::unordered_map<std::string_view, ArgId> nameIndex;
+#endif
+
+	// Generated table replacing nameIndex, see NameTable
+	const NameTable* nameTable = nullptr;
+
+	// Names of the environment variables read by the arguments
+	std::pmr::unordered_map<std::string_view, ArgId> environmentIndex;
+
+	// Keys of the configuration files: the names without their leading dashes
+	std::pmr::unordered_map<std::string_view, ArgId> configIndex;
+
+	// Node of the BK-tree of the names: the children of a node are at distinct edit distances from it
+	struct NameNode {
+		std::string_view name;
+		ArgId id;
+		std::uint32_t distance;    ///< distance from the parent.
+		std::uint32_t firstChild;  ///< index of the first child, 0 if there is none.
+		std::uint32_t nextSibling; ///< index of the next child of the parent, 0 if there is none.
+	};
+
+	// Indexes of the unknown tokens, built on the first use (strict parses only)
+	mutable std::once_flag nearIndexOnce;
+	mutable std::pmr::vector<std::pair<std::string_view, ArgId>> longNames;
+	mutable std::pmr::vector<NameNode> nameTree;
+
+	void build();
+	void addName(const std::string& name, ArgId id);
+	void addEnvironment(const Argument& arg, ArgId id);
+	void buildNearIndex() const;
+	ParseError matchArgv(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+		ParseResult& result, ParseOptions options) const;
+	ParseError matchCommandLine(char* commandLine, std::size_t size, ParseResult& result, ParseOptions options) const;
+
+public:
+
+	/**
+		@brief constructor.
+		@throw If the argument names are duplicated or the sizes of the vectors differ.
+		@param arguments registered arguments.
+		@param flags flags of the arguments, combination of ParserPlan::Flags.
+		ParserPlan::repeatable is added for the repeatable arguments.
+		@param resource memory resource of the storage of the plan, must outlive the plan.
+	*/
+	ParserPlan(std::vector<Argument> arguments, std::vector<std::uint8_t> flags,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	/**
+		@brief constructor.
+		@throw If the argument names are duplicated or the sizes of the vectors differ.
+		@param arguments registered arguments.
+		@param flags flags of the arguments, combination of ParserPlan::Flags.
+		@param resource memory resource of the storage of the plan, must outlive the plan.
+		@param nameTable generated table of the names of the arguments, must outlive the plan; NULL to index the names.
+		@throw If the table does not hold exactly the names of the arguments.
+	*/
+	ParserPlan(const std::pmr::vector<Argument>& arguments, const std::pmr::vector<std::uint8_t>& flags,
+		std::pmr::memory_resource* resource, const NameTable* nameTable = nullptr);
+
+	ParserPlan(const ParserPlan&) = delete;
+	ParserPlan& operator=(const ParserPlan&) = delete;
+
+	/**
+		@brief Returns TRUE if the token can be the content of the preceding argument: not empty and not starting with '-'.
+		@param token token of the command line.
+	*/
+	static bool isContent(std::string_view token) noexcept;
+
+	/**
+		@brief Returns TRUE if the token is a negative number, which is also the content of a numeric argument.
+		@param token token of the command line.
+		@param type type of the preceding argument.
+	*/
+	static bool isNegativeNumber(std::string_view token, ValueType type) noexcept;
+
+	/**
+		@brief Returns the environment of the process: NAME=VALUE strings terminated by NULL, like environ.
+	*/
+	static const char* const* processEnvironment() noexcept;
+
+	/**
+		@brief Returns TRUE if the token is taken as content by the argument waiting for it:
+		a value, or a negative number of a numeric argument which is not a registered name.
+		@param id handle of the argument waiting for its content.
+		@param token token of the command line.
+		@param kind kind of the token, see TokenClassifier.
+	*/
+	bool takesContent(ArgId id, std::string_view token, TokenKind kind) const noexcept;
+
+	/**
+		@brief Returns the number of registered arguments.
+	*/
+	std::uint32_t size() const noexcept;
+
+	/**
+		@brief Returns the number of 64-bit words in the bitmasks of this plan.
+	*/
+	std::size_t wordCount() const noexcept;
+
+	/**
+		@brief Returns the argument with the specified handle.
+		@param id handle of the argument.
+	*/
+	const Argument& argument(ArgId id) const;
+
+	/**
+		@brief Returns the flags of the argument with the specified handle.
+		@param id handle of the argument.
+	*/
+	std::uint8_t argumentFlags(ArgId id) const;
+
+	/**
+		@brief Returns the count of content tokens of the argument with the specified handle (see Argument::getArity()).
+		@param id handle of the argument.
+	*/
+	std::uint32_t argumentArity(ArgId id) const;
+
+	/**
+		@brief Returns the type of the content of the argument with the specified handle.
+		@param id handle of the argument.
+	*/
+	ValueType argumentType(ArgId id) const;
+
+	/**
+		@brief Returns the handle of the argument with the specified name (arg1 or arg2).
+		@return Handle of the argument or ParserPlan::npos if the name is not registered.
+		@param name name of the argument.
+	*/
+	ArgId find(std::string_view name) const noexcept;
+
+	/**
+		@brief Returns the handle of the argument whose name starting with "--" begins with the prefix.
+		The sorted table of the names is built on the first call.
+		@return Handle of the argument, ParserPlan::npos if no name or the names of several arguments begin with the prefix.
+		@param prefix beginning of a name, starting with "--".
+		@param ambiguous receives TRUE if the names of several arguments begin with the prefix.
+	*/
+	ArgId findAbbreviation(std::string_view prefix, bool& ambiguous) const;
+
+	/**
+		@brief Returns the registered names nearest to the token by edit distance, to suggest them for an unknown token.
+		The names are searched in a BK-tree built on the first call, which skips the subtrees whose distance
+		to the visited nodes excludes a match. With the radius of 2 a large part of the tree is still visited:
+		the gain over a scan of all names is a constant factor (2 to 5 on 5000 names, see the suggest cases of the benchmark).
+		@return Handles of the arguments of the nearest names, ordered by distance; at most count,
+		the distance is at most 1 for the tokens up to 4 characters, otherwise 2.
+		@param token unknown token.
+		@param count maximal count of the suggestions.
+	*/
+	std::vector<ArgId> suggest(std::string_view token, std::size_t count = 3) const;
+
+	/**
+		@brief Returns the handle of the argument reading the environment variable (see Argument::setEnv()).
+		@return Handle of the argument or ParserPlan::npos if no argument reads the variable.
+		@param name name of the environment variable.
+	*/
+	ArgId findEnvironment(std::string_view name) const noexcept;
+
+	/**
+		@brief Returns the count of arguments reading an environment variable.
+	*/
+	std::uint32_t environmentCount() const noexcept;
+
+	/**
+		@brief Returns the handle of the argument set by the key of a configuration file (see ConfigFile).
+		@return Handle of the argument or ParserPlan::npos if no name of an argument is the key.
+		@param key key of the configuration file.
+	*/
+	ArgId findConfigKey(std::string_view key) const noexcept;
+
+	/**
+		@brief Returns the handle of the argument matching at least one name of arg.
+		@return Handle of the argument or ParserPlan::npos if the argument is not registered.
+		@param arg argument.
+	*/
+	ArgId indexOf(const Argument& arg) const noexcept;
+
+	/**
+		@brief Returns the bitmask of the required arguments.
+	*/
+	const std::pmr::vector<std::uint64_t>& getRequiredMask() const noexcept;
+
+	/**
+		@brief Returns the bitmask of the arguments of the required set.
+	*/
+	const std::pmr::vector<std::uint64_t>& getRequiredSetMask() const noexcept;
+
+	/**
+		@brief Returns TRUE if at least one required argument was added, otherwise FALSE.
+	*/
+	bool requiresArgs() const noexcept;
+
+	/**
+		@brief Returns TRUE if at least one argument was added to the required set, otherwise FALSE.
+	*/
+	bool requiresSet() const noexcept;
+
+	/**
+		@brief Performs parsing of passed arguments, validation of input arguments, and extraction of argument values.
+		The method does not modify the plan and can be called concurrently from several threads with different results.
+		@throw If argc == 0, beginIdx > argc, argv is NULL pointer, required argument or content not found.
+		@param argc count of arguments.
+		@param argv arguments array.
+		@param beginIdx initial argument number.
+		@param result receives the parsed arguments, its memory is reused.
+		@param options storage of the extracted content and expansion of response files.
+	*/
+	void parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+		ParseResult& result, ParseOptions options = ParseOptions()) const;
+
+	/**
+		@brief Performs parsing of passed arguments, validation of input arguments, and extraction of argument values.
+		@return Parsed arguments.
+		@throw If argc == 0, beginIdx > argc, argv is NULL pointer, required argument or content not found.
+		@param argc count of arguments.
+		@param argv arguments array.
+		@param beginIdx initial argument number.
+		@param options storage of the extracted content and expansion of response files.
+	*/
+	ParseResult parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+		ParseOptions options = ParseOptions()) const;
+
+	/**
+		@brief Performs parsing like parse(), but reports the first invalid input as an error instead of throwing.
+		@return The first error, ParseErrc::none if the arguments are valid.
+		@param argc count of arguments.
+		@param argv arguments array.
+		@param beginIdx initial argument number.
+		@param result receives the parsed arguments, its memory is reused.
+		@param options storage of the extracted content and expansion of response files.
+	*/
+	ParseError tryParse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+		ParseResult& result, ParseOptions options = ParseOptions()) const;
+
+	/**
+		@brief Performs parsing like parse() without throwing and without stopping at the first error:
+		all errors are collected in one pass (see ParseResult::errors()), the messages are not formatted.
+		@return Outcome holding the result or the errors.
+		@param argc count of arguments.
+		@param argv arguments array.
+		@param beginIdx initial argument number.
+		@param result receives the parsed arguments and the errors, its memory is reused.
+		@param options storage of the extracted content and expansion of response files.
+	*/
+	ParseOutcome tryParseAll(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+		ParseResult& result, ParseOptions options = ParseOptions()) const noexcept;
+
+	/**
+		@brief Performs parsing of a whole command line, tokenized in place by Tokenizer.
+		The tokens are views into the command line, no intermediate containers are created.
+		With ContentMode::view the extracted content points into the command line.
+		@throw If an argument or content is not found or a quote is not terminated.
+		@param commandLine command line, modified by the tokenization.
+		@param size size of the command line.
+		@param result receives the parsed arguments, its memory is reused.
+		@param options storage of the extracted content and expansion of response files.
+	*/
+	void parseCommandLine(char* commandLine, std::size_t size,
+		ParseResult& result, ParseOptions options = ParseOptions()) const;
+
+	/**
+		@brief Performs parsing of a whole command line, tokenized in place by Tokenizer.
+		@throw If an argument or content is not found or a quote is not terminated.
+		@param commandLine command line, modified by the tokenization.
+		@param result receives the parsed arguments, its memory is reused.
+		@param options storage of the extracted content and expansion of response files.
+	*/
+	void parseCommandLine(std::string& commandLine, ParseResult& result, ParseOptions options = ParseOptions()) const;
+
+	/**
+		@brief Performs parsing of a whole command line like parseCommandLine(), but reports the first error instead of throwing.
+		@return The first error, ParseErrc::none if the arguments are valid. The token index is the index in the command line.
+		@param commandLine command line, modified by the tokenization.
+		@param size size of the command line.
+		@param result receives the parsed arguments, its memory is reused.
+		@param options storage of the extracted content and expansion of response files.
+	*/
+	ParseError tryParseCommandLine(char* commandLine, std::size_t size,
+		ParseResult& result, ParseOptions options = ParseOptions()) const;
+
+	/**
+		@brief Formats the message of the error.
+		@return Message describing the error.
+		@param error error returned by tryParse().
+		@param options options of the parse, the message names the configuration file of the error.
+	*/
+	std::string errorMessage(const ParseError& error, const ParseOptions& options = ParseOptions()) const;
+
+	/**
+		@brief Throws the exception corresponding to the error: InvalidArg for invalid arguments,
+		std::invalid_argument or std::runtime_error for invalid parameters of the call.
+		@param error error returned by tryParse(), must not be ParseErrc::none.
+		@param options options of the parse, the message names the configuration file of the error.
+	*/
+	[[noreturn]] void throwError(const ParseError& error, const ParseOptions& options = ParseOptions()) const;
+
+	/**
+		@brief Ends the statistics of a parse: counts the error in the result and adds its counters to the plan.
+		Called by the parsers of this library, does nothing without ARGSMANAGER_STATS.
+		@param result result of the parse.
+		@param error error ending the parse, ParseErrc::none if the arguments are valid.
+	*/
+#ifdef ARGSMANAGER_STATS
+	void recordStats(ParseResult& result, const ParseError& error) const noexcept;
+#else
+	void recordStats(ParseResult&, const ParseError&) const noexcept {}
+#endif
+
+	/**
+		@brief Returns the sum of the counters of all parses against this plan, zero without ARGSMANAGER_STATS.
+		Can be called while other threads are parsing.
+	*/
+	ParseStats cumulativeStats() const noexcept;
+
+	/**
+		@brief Sets the counters of cumulativeStats() to zero.
+	*/
+	void clearStats() const noexcept;
+};
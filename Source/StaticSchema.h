@@ -0,0 +1,473 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "ArgsManager.h"
+
+/**
+	@brief
+	Argument known at compile time, its names view string literals.
+	A constexpr instance costs nothing at the static initialization, unlike an Argument which owns its names.
+*/
+class StaticArgument
+{
+
+private:
+
+	std::string_view arg1;
+	std::string_view arg2;
+	ValueType valueType = ValueType::string;
+	bool content = false;
+	bool mandatory = false;
+	bool inSet = false;
+
+public:
+
+	/**
+		@brief constructor.
+		@param hasContent flag indicating whether the argument contains content.
+		@param arg1 argument (required), checked by StaticSchema.
+		@param arg2 argument (optional).
+	*/
+	constexpr StaticArgument(bool hasContent, std::string_view arg1, std::string_view arg2 = std::string_view()) noexcept :
+		arg1(arg1), arg2(arg2), content(hasContent) {}
+
+	/**
+		@brief Returns a copy of the argument which must be passed.
+	*/
+	constexpr StaticArgument required() const noexcept
+	{
+		StaticArgument copy = *this;
+		copy.mandatory = true;
+		return copy;
+	}
+
+	/**
+		@brief Returns a copy of the argument which belongs to the set of arguments of which at least one must be passed.
+	*/
+	constexpr StaticArgument requiredToSet() const noexcept
+	{
+		StaticArgument copy = *this;
+		copy.inSet = true;
+		return copy;
+	}
+
+	/**
+		@brief Returns a copy of the argument with the type of its content, see Argument::setType().
+		StaticSchema::parse() uses the type only to take negative numbers as content.
+		@param type type of the content.
+	*/
+	constexpr StaticArgument ofType(ValueType type) const noexcept
+	{
+		StaticArgument copy = *this;
+		copy.valueType = type;
+		return copy;
+	}
+
+	/**
+		@brief Returns argument 1.
+	*/
+	constexpr std::string_view getArg1() const noexcept { return arg1; }
+
+	/**
+		@brief Returns argument 2.
+	*/
+	constexpr std::string_view getArg2() const noexcept { return arg2; }
+
+	/**
+		@brief Returns TRUE if content should be passed to the argument, otherwise FALSE.
+	*/
+	constexpr bool hasContent() const noexcept { return content; }
+
+	/**
+		@brief Returns TRUE if the argument must be passed, otherwise FALSE.
+	*/
+	constexpr bool isRequired() const noexcept { return mandatory; }
+
+	/**
+		@brief Returns TRUE if the argument belongs to the required set, otherwise FALSE.
+	*/
+	constexpr bool isRequiredToSet() const noexcept { return inSet; }
+
+	/**
+		@brief Returns the type of the content.
+	*/
+	constexpr ValueType getType() const noexcept { return valueType; }
+
+	/**
+		@brief Returns TRUE if one of the names matches, otherwise FALSE.
+		@param name name of the argument.
+	*/
+	constexpr bool operator==(std::string_view name) const noexcept
+	{
+		return name == arg1 || (!arg2.empty() && name == arg2);
+	}
+
+	/**
+		@brief Returns the Argument with the same names, to register it to an ArgsManager.
+	*/
+	Argument toArgument() const
+	{
+		Argument argument(content, std::string(arg1), std::string(arg2));
+		argument.setType(valueType);
+		return argument;
+	}
+};
+
+#ifdef __cpp_consteval
+
+/**
+	@brief
+	Result of StaticSchema::parse(), fixed arrays indexed by ArgId.
+	The content views the passed argv, as with ContentMode::view.
+*/
+template<std::size_t N>
+class StaticResult
+{
+
+private:
+
+	template<std::size_t> friend class StaticSchema;
+
+	std::array<Content, N> values{};
+	std::array<std::uint32_t, N> occurrences{};
+
+	void checkId(ArgId id) const
+	{
+		if (id >= N)
+			throw std::out_of_range("Identifier of the argument is out of range");
+	}
+
+	void clear() noexcept
+	{
+		values.fill(Content());
+		occurrences.fill(0);
+	}
+
+public:
+
+	/**
+		@brief Returns the content of the first occurrence of the argument, empty if it is not present.
+		@throw If id is out of range.
+		@param id handle of the argument, its index in the schema.
+	*/
+	Content argValue(ArgId id) const
+	{
+		checkId(id);
+		return values[id];
+	}
+
+	/**
+		@brief Checks if the argument is present in the passed arguments.
+		@throw If id is out of range.
+		@param id handle of the argument, its index in the schema.
+	*/
+	bool argPresent(ArgId id) const
+	{
+		checkId(id);
+		return occurrences[id] != 0;
+	}
+
+	/**
+		@brief Returns how many times the argument is present in the passed arguments.
+		@throw If id is out of range.
+		@param id handle of the argument, its index in the schema.
+	*/
+	std::uint32_t argOccurrences(ArgId id) const
+	{
+		checkId(id);
+		return occurrences[id];
+	}
+};
+
+/**
+	@brief
+	Set of arguments fixed at compile time (C++20, checked by the ArgsManagerStaticSchema test of CMake).
+	The schema is built by a consteval constructor: an empty name or a name given to two arguments
+	does not compile, and the names are sorted into a fixed table searched by binary search.
+	parse() follows the rules of the matcher (see Matcher) without allocating and without registering anything
+	at run time: --name=value, -ofile and bundles, the content taken as by ParserPlan::takesContent() (negative numbers
+	for the numeric types), "--" if it ends the options, the required arguments and the required set. Tokens which name no argument are ignored.
+	It differs from ParserPlan::parse() in what the schema does not describe: each argument with content takes one value,
+	the content of the first occurrence is kept and is not converted; there are no environment, configuration files,
+	response files or strict parses. These settings need the ArgsManager, see registerTo().
+	The header is not included by ArgsManager.h.
+
+	Example:
+		constexpr StaticSchema schema{
+			StaticArgument(true, "-i", "--input").required(),
+			StaticArgument(false, "--move")
+		};
+		constexpr ArgId input = schema.find("--input");
+*/
+template<std::size_t N>
+class StaticSchema
+{
+
+private:
+
+	struct Name {
+		std::string_view name;
+		ArgId id = ParserPlan::npos;
+	};
+
+	std::array<StaticArgument, N> arguments;
+	std::array<Name, 2 * N> names{};
+	std::size_t nameCount = 0;
+
+	static constexpr bool lessName(const Name& left, const Name& right) noexcept
+	{
+		return left.name < right.name;
+	}
+
+	// Returns TRUE if each character of -xvf names an argument, up to the first one which takes the rest as content
+	constexpr bool isBundle(std::string_view token) const noexcept
+	{
+		for (std::size_t pos = 1; pos < token.size(); ++pos) {
+			const char name[2] = { '-', token[pos] };
+			const ArgId id = find(std::string_view(name, 2));
+			if (id == ParserPlan::npos)
+				return false;
+			if (arguments[id].hasContent())
+				break;
+		}
+		return true;
+	}
+
+public:
+
+	/**
+		@brief constructor, evaluated at compile time.
+		@param args arguments of the schema, the handle of an argument is its index.
+	*/
+	template<typename... Arguments>
+	consteval explicit StaticSchema(const Arguments&... args) :
+		arguments{ args... }
+	{
+		for (std::size_t id = 0; id < N; ++id) {
+			const StaticArgument& argument = arguments[id];
+			if (argument.getArg1().empty())
+				throw std::invalid_argument("Add argument cannot be empty!");
+
+			names[nameCount++] = { argument.getArg1(), static_cast<ArgId>(id) };
+			if (!argument.getArg2().empty() && argument.getArg2() != argument.getArg1())
+				names[nameCount++] = { argument.getArg2(), static_cast<ArgId>(id) };
+		}
+
+		std::sort(names.begin(), names.begin() + nameCount, lessName);
+
+		for (std::size_t idx = 1; idx < nameCount; ++idx) {
+			if (names[idx - 1].name == names[idx].name)
+				throw std::logic_error("This argument has already been added");
+		}
+	}
+
+	/**
+		@brief Returns the count of arguments.
+	*/
+	static constexpr std::size_t size() noexcept { return N; }
+
+	/**
+		@brief Returns the argument with the specified handle.
+		@param id handle of the argument.
+	*/
+	constexpr const StaticArgument& argument(ArgId id) const { return arguments.at(id); }
+
+	/**
+		@brief Returns the handle of the argument with the name, ParserPlan::npos if there is none.
+		@param name name of the argument.
+	*/
+	constexpr ArgId find(std::string_view name) const noexcept
+	{
+		const auto last = names.begin() + nameCount;
+		const auto found = std::lower_bound(names.begin(), last, Name{ name }, lessName);
+		return (found != last && found->name == name) ? found->id : ParserPlan::npos;
+	}
+
+	/**
+		@brief Returns TRUE if at least one argument must be passed, otherwise FALSE.
+	*/
+	constexpr bool requiresArgs() const noexcept
+	{
+		return std::any_of(arguments.begin(), arguments.end(), [](const StaticArgument& argument) {
+			return argument.isRequired();
+		});
+	}
+
+	/**
+		@brief Returns TRUE if at least one argument of the required set must be passed, otherwise FALSE.
+	*/
+	constexpr bool requiresSet() const noexcept
+	{
+		return std::any_of(arguments.begin(), arguments.end(), [](const StaticArgument& argument) {
+			return argument.isRequiredToSet();
+		});
+	}
+
+	/**
+		@brief Parses the arguments, the first error stops the parse.
+		Messages of the errors are formatted by the plan of an ArgsManager filled by registerTo().
+		@return Error of the parse, ParseErrc::none if the arguments are valid.
+		@param argc count of arguments.
+		@param argv arguments array, must outlive the result.
+		@param beginIdx initial argument number.
+		@param result receives the parsed arguments.
+		@param optionsTerminator TRUE to end the options at the token "--", see ParseOptions::optionsTerminator.
+	*/
+	ParseError parse(const unsigned int argc, const char* const argv[], unsigned int beginIdx,
+		StaticResult<N>& result, bool optionsTerminator = false) const noexcept
+	{
+		result.clear();
+
+		if (argc == 0 && (requiresArgs() || requiresSet()))
+			return { ParseErrc::noArguments };
+
+		if (argc > 0 && argv == nullptr)
+			return { ParseErrc::nullArgv };
+
+		if (beginIdx > argc)
+			return { ParseErrc::beginOutOfRange };
+
+		// Argument waiting for its content; the content of a repeated argument is optional and skipped, as in Matcher
+		ArgId pending = ParserPlan::npos;
+		std::uint32_t pendingToken = 0;
+		bool collect = false;
+		bool ended = false;
+
+		const auto start = [&](ArgId id, std::uint32_t idx) {
+			const bool first = ++result.occurrences[id] == 1;
+			if (arguments[id].hasContent()) {
+				pending = id;
+				pendingToken = idx;
+				collect = first;
+			}
+		};
+
+		const auto content = [&](std::string_view token) {
+			if (collect)
+				result.values[pending] = token;
+			pending = ParserPlan::npos;
+		};
+
+		for (unsigned int idx = beginIdx; idx < argc; ++idx) {
+			if (argv[idx] == nullptr) {
+				if (pending != ParserPlan::npos && collect)
+					return { ParseErrc::missingContent, pendingToken, pending };
+				return { ParseErrc::nullArgument, idx };
+			}
+
+			// The tokens following "--" are operands, even if they start with '-'
+			const std::string_view token(argv[idx]);
+			if (ended)
+				continue;
+
+			std::uint32_t split = TokenClassifier::noSplit;
+			const TokenKind kind = TokenClassifier::classify(token, split);
+
+			if (pending != ParserPlan::npos) {
+				if (kind == TokenKind::value || (kind == TokenKind::negativeNumber &&
+					ParserPlan::isNegativeNumber(token, arguments[pending].getType()) && find(token) == ParserPlan::npos)) {
+					content(token);
+					continue;
+				}
+
+				if (collect)
+					return { ParseErrc::missingContent, pendingToken, pending };
+				pending = ParserPlan::npos;
+			}
+
+			if (kind == TokenKind::terminator && optionsTerminator) {
+				ended = true;
+				continue;
+			}
+
+			// A name is matched as a whole first, even if it contains '='
+			ArgId id = find(token);
+			if (id != ParserPlan::npos) {
+				start(id, idx);
+				continue;
+			}
+
+			if (kind == TokenKind::longOptionValue) {
+				id = find(token.substr(0, split));
+				if (id == ParserPlan::npos)
+					continue;
+
+				if (!arguments[id].hasContent())
+					return { ParseErrc::unexpectedValue, idx, id };
+
+				// The value is content even if it starts with '-'
+				start(id, idx);
+				content(token.substr(split + 1));
+				continue;
+			}
+
+			// -xvf records -x, -v and -f; the first argument with content takes the rest of the token or the next token
+			if (kind != TokenKind::shortOption || token.size() <= 2 || !isBundle(token))
+				continue;
+
+			for (std::size_t pos = 1; pos < token.size(); ++pos) {
+				const char name[2] = { '-', token[pos] };
+				id = find(std::string_view(name, 2));
+				start(id, idx);
+
+				if (arguments[id].hasContent()) {
+					if (pos + 1 < token.size())
+						content(token.substr(pos + 1));
+					break;
+				}
+			}
+		}
+
+		if (pending != ParserPlan::npos && collect)
+			return { ParseErrc::missingContent, pendingToken, pending };
+
+		for (std::size_t id = 0; id < N; ++id) {
+			if (arguments[id].isRequired() && result.occurrences[id] == 0)
+				return { ParseErrc::missingRequired, ParseError::noToken, static_cast<ArgId>(id) };
+		}
+
+		if (requiresSet()) {
+			bool setFound = false;
+			for (std::size_t id = 0; id < N && !setFound; ++id)
+				setFound = arguments[id].isRequiredToSet() && result.occurrences[id] != 0;
+
+			if (!setFound)
+				return { ParseErrc::missingRequiredFromSet };
+		}
+
+		return {};
+	}
+
+	/**
+		@brief Registers the arguments to the manager in the order of the schema,
+		the handles are the same if the manager has no other arguments.
+		@return Reference to the manager.
+		@throw If an argument is already registered to the manager.
+		@param manager manager receiving the arguments.
+	*/
+	ArgsManager& registerTo(ArgsManager& manager) const
+	{
+		for (const StaticArgument& argument : arguments) {
+			if (argument.isRequired())
+				manager.addRequired(argument.toArgument());
+			else if (argument.isRequiredToSet())
+				manager.addRequiredToSet(argument.toArgument());
+			else
+				manager.addOptional(argument.toArgument());
+		}
+
+		return manager;
+	}
+};
+
+template<typename... Arguments>
+StaticSchema(const Arguments&...) -> StaticSchema<sizeof...(Arguments)>;
+
+#endif
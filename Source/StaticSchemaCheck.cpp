@@ -0,0 +1,85 @@
+/**
+	Check of StaticSchema, which needs C++20: built by the CMake option ARGSMANAGER_STATIC_SCHEMA and run by ctest.
+	The schema is built at compile time, its parses are compared with the parses of the plan of the same arguments.
+*/
+
+#include "StaticSchema.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+	constexpr StaticSchema schema{
+		StaticArgument(true, "-i", "--input").required(),
+		StaticArgument(true, "-n", "--count").ofType(ValueType::integer),
+		StaticArgument(false, "-v"),
+		StaticArgument(false, "-q"),
+		StaticArgument(true, "-o", "--output").requiredToSet(),
+		StaticArgument(false, "--all").requiredToSet()
+	};
+
+	static_assert(schema.size() == 6 && schema.find("--count") == 1 && schema.find("-x") == ParserPlan::npos);
+	static_assert(schema.requiresArgs() && schema.requiresSet());
+
+	const std::vector<std::vector<const char*>> lines = {
+		{ "-i", "a", "--all" },
+		{ "-i", "a", "-n", "-5", "-o", "b" },
+		{ "--input=a", "-vqo", "b", "-i", "c" },
+		{ "-i", "a", "-vqob" },
+		{ "-i", "-5", "--all" },
+		{ "-i", "a", "--all", "--", "-n" },
+		{ "-i", "a", "--all=yes" },
+		{ "-i", "a", "-n" },
+		{ "-i", "a", "-x", "--unknown", "-n", "-5", "-o=b" },
+		{ "-vq", "--all" },
+		{ "-i", "a" },
+		{ "-i", "a", "-i", "-v", "--all" }
+	};
+
+	// Returns TRUE if the schema and the plan give the same error and the same arguments
+	bool sameParse(const ParserPlan& plan, const std::vector<const char*>& line)
+	{
+		const unsigned int argc = static_cast<unsigned int>(line.size());
+
+		StaticResult<schema.size()> staticResult;
+		const ParseError staticError = schema.parse(argc, line.data(), 0, staticResult);
+
+		ParseResult result;
+		const ParseError error = plan.tryParse(argc, line.data(), 0, result, ParseOptions(ContentMode::view));
+
+		if (staticError.code != error.code || staticError.token != error.token || staticError.arg != error.arg)
+			return false;
+
+		if (error)
+			return true;
+
+		for (ArgId id = 0; id < schema.size(); ++id) {
+			if (staticResult.argOccurrences(id) != result.argOccurrences(id))
+				return false;
+
+			if (schema.argument(id).hasContent() && result.argPresent(id) && staticResult.argValue(id) != result.argValue(id))
+				return false;
+		}
+
+		return true;
+	}
+
+}
+
+int main()
+{
+	ArgsManager manager;
+	schema.registerTo(manager);
+	const auto plan = manager.freeze();
+
+	int failures = 0;
+	for (std::size_t idx = 0; idx < lines.size(); ++idx) {
+		if (!sameParse(*plan, lines[idx])) {
+			std::fprintf(stderr, "Line %zu: the static schema and the plan differ\n", idx + 1);
+			++failures;
+		}
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+#include "ArgsManager.h"
+
+#if !defined(ARGSMANAGER_NO_SIMD) && defined(__AVX2__)
+#define ARGSMANAGER_CLASSIFY_AVX2
+#include <immintrin.h>
+#elif !defined(ARGSMANAGER_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ARGSMANAGER_CLASSIFY_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(ARGSMANAGER_CLASSIFY_AVX2) || defined(ARGSMANAGER_CLASSIFY_SSE2))
+#include <intrin.h>
+#endif
+
+namespace {
+
+	bool isDigit(char symbol)
+	{
+		return symbol >= '0' && symbol <= '9';
+	}
+
+	TokenKind scalarKind(std::string_view token)
+	{
+		if (token.empty())
+			return TokenKind::empty;
+
+		if (token[0] != '-')
+			return TokenKind::value;
+
+		if (token.size() > 1 && token[1] == '-')
+			return (token.size() == 2) ? TokenKind::terminator : TokenKind::longOption;
+
+		if (token.size() > 1 && (isDigit(token[1]) || token[1] == '.'))
+			return TokenKind::negativeNumber;
+
+		return TokenKind::shortOption;
+	}
+
+#if defined(ARGSMANAGER_CLASSIFY_AVX2) || defined(ARGSMANAGER_CLASSIFY_SSE2)
+	unsigned lowestBit(unsigned mask)
+	{
+#ifdef _MSC_VER
+		unsigned long idx;
+		_BitScanForward(&idx, mask);
+		return static_cast<unsigned>(idx);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+#endif
+
+	std::uint32_t splitAt(std::size_t pos)
+	{
+		// The name before '=' must not be empty
+		return (pos > 2) ? static_cast<std::uint32_t>(pos) : TokenClassifier::noSplit;
+	}
+
+#if defined(ARGSMANAGER_CLASSIFY_AVX2) || defined(ARGSMANAGER_CLASSIFY_SSE2)
+	/*
+		Position of '=' after the leading "--" of a long option.
+		The token is scanned in aligned blocks of 16 characters: an aligned load never crosses a page,
+		so the characters outside of the token are read safely and masked out. They are not part of
+		any object, which the address sanitizer would report.
+	*/
+#if defined(_MSC_VER)
+	__declspec(no_sanitize_address)
+#elif defined(__GNUC__)
+	__attribute__((no_sanitize_address))
+#endif
+	std::uint32_t findSplit(std::string_view token)
+	{
+		const char* const begin = token.data() + 2;
+		const char* const end = token.data() + token.size();
+		if (begin >= end)
+			return TokenClassifier::noSplit;
+
+		const __m128i equals = _mm_set1_epi8('=');
+		const char* block = reinterpret_cast<const char*>(reinterpret_cast<std::uintptr_t>(begin) & ~std::uintptr_t(15));
+
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+			_mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(block)), equals)));
+		mask &= ~0u << (begin - block);
+
+		for (;;) {
+			const std::size_t available = static_cast<std::size_t>(end - block);
+			if (available < 16)
+				mask &= (1u << available) - 1;
+
+			if (mask != 0)
+				return splitAt(static_cast<std::size_t>(block + lowestBit(mask) - token.data()));
+
+			block += 16;
+			if (block >= end)
+				return TokenClassifier::noSplit;
+
+			mask = static_cast<unsigned>(_mm_movemask_epi8(
+				_mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(block)), equals)));
+		}
+	}
+#else
+	// Position of '=' after the leading "--" of a long option
+	std::uint32_t findSplit(std::string_view token)
+	{
+		for (std::size_t pos = 2; pos < token.size(); ++pos) {
+			if (token[pos] == '=')
+				return splitAt(pos);
+		}
+
+		return TokenClassifier::noSplit;
+	}
+#endif
+
+#if defined(ARGSMANAGER_CLASSIFY_AVX2) || defined(ARGSMANAGER_CLASSIFY_SSE2)
+#if defined(ARGSMANAGER_CLASSIFY_AVX2)
+	constexpr std::size_t blockSize = 32;
+#else
+	constexpr std::size_t blockSize = 16;
+#endif
+
+	// Packs the byte at shift of 16 words into 16 bytes
+	__m128i packBytes(const std::uint32_t* words, int shift)
+	{
+		const __m128i mask = _mm_set1_epi32(0xFF);
+		const auto load = [&](std::size_t idx) {
+			return _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + idx)), shift), mask);
+		};
+
+		return _mm_packus_epi16(_mm_packs_epi32(load(0), load(4)), _mm_packs_epi32(load(8), load(12)));
+	}
+
+	// Classifies blockSize tokens from their first two characters and their lengths, without branches
+	void classifyBlock(const std::string_view* tokens, TokenKind* kinds)
+	{
+		// Each word holds the first character, the second character and the length limited to 3
+		std::uint32_t words[blockSize];
+
+		for (std::size_t idx = 0; idx < blockSize; ++idx) {
+			const std::string_view token = tokens[idx];
+			const std::uint32_t first = token.empty() ? 0 : static_cast<unsigned char>(token[0]);
+			const std::uint32_t second = (token.size() > 1) ? static_cast<unsigned char>(token[1]) : 0;
+			const std::uint32_t length = static_cast<std::uint32_t>((token.size() < 3) ? token.size() : 3);
+			words[idx] = first | (second << 8) | (length << 16);
+		}
+
+#if defined(ARGSMANAGER_CLASSIFY_AVX2)
+		const auto bytes = [&](int shift) {
+			return _mm256_inserti128_si256(_mm256_castsi128_si256(packBytes(words, shift)), packBytes(words + 16, shift), 1);
+		};
+
+		const __m256i c0 = bytes(0);
+		const __m256i c1 = bytes(8);
+		const __m256i length = bytes(16);
+		const __m256i dash = _mm256_set1_epi8('-');
+
+		const __m256i dash0 = _mm256_cmpeq_epi8(c0, dash);
+		const __m256i dash1 = _mm256_cmpeq_epi8(c1, dash);
+		const __m256i empty = _mm256_cmpeq_epi8(length, _mm256_setzero_si256());
+		const __m256i twoChars = _mm256_cmpeq_epi8(length, _mm256_set1_epi8(2));
+		const __m256i number = _mm256_or_si256(
+			_mm256_and_si256(_mm256_cmpgt_epi8(c1, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c1)),
+			_mm256_cmpeq_epi8(c1, _mm256_set1_epi8('.')));
+
+		const auto kind = [](TokenKind value) { return _mm256_set1_epi8(static_cast<char>(value)); };
+
+		const __m256i longKind = _mm256_blendv_epi8(kind(TokenKind::longOption), kind(TokenKind::terminator), twoChars);
+		const __m256i shortKind = _mm256_blendv_epi8(kind(TokenKind::shortOption), kind(TokenKind::negativeNumber), number);
+		const __m256i dashKind = _mm256_blendv_epi8(shortKind, longKind, dash1);
+		const __m256i plainKind = _mm256_blendv_epi8(kind(TokenKind::value), kind(TokenKind::empty), empty);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(kinds), _mm256_blendv_epi8(plainKind, dashKind, dash0));
+#else
+		const __m128i c0 = packBytes(words, 0);
+		const __m128i c1 = packBytes(words, 8);
+		const __m128i length = packBytes(words, 16);
+		const __m128i dash = _mm_set1_epi8('-');
+
+		const __m128i dash0 = _mm_cmpeq_epi8(c0, dash);
+		const __m128i dash1 = _mm_cmpeq_epi8(c1, dash);
+		const __m128i empty = _mm_cmpeq_epi8(length, _mm_setzero_si128());
+		const __m128i twoChars = _mm_cmpeq_epi8(length, _mm_set1_epi8(2));
+		const __m128i number = _mm_or_si128(
+			_mm_and_si128(_mm_cmpgt_epi8(c1, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c1)),
+			_mm_cmpeq_epi8(c1, _mm_set1_epi8('.')));
+
+		const auto kind = [](TokenKind value) { return _mm_set1_epi8(static_cast<char>(value)); };
+
+		// SSE2 has no byte blend: select(mask, a, b) = (mask & a) | (~mask & b)
+		const auto select = [](__m128i mask, __m128i chosen, __m128i other) {
+			return _mm_or_si128(_mm_and_si128(mask, chosen), _mm_andnot_si128(mask, other));
+		};
+
+		const __m128i longKind = select(twoChars, kind(TokenKind::terminator), kind(TokenKind::longOption));
+		const __m128i shortKind = select(number, kind(TokenKind::negativeNumber), kind(TokenKind::shortOption));
+		const __m128i dashKind = select(dash1, longKind, shortKind);
+		const __m128i plainKind = select(empty, kind(TokenKind::empty), kind(TokenKind::value));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(kinds), select(dash0, dashKind, plainKind));
+#endif
+	}
+#endif
+
+}
+
+TokenKind TokenClassifier::classify(std::string_view token, std::uint32_t& split) noexcept
+{
+	TokenKind kind = scalarKind(token);
+	split = noSplit;
+
+	if (kind == TokenKind::longOption) {
+		split = findSplit(token);
+		if (split != noSplit)
+			kind = TokenKind::longOptionValue;
+	}
+
+	return kind;
+}
+
+void TokenClassifier::classify(const std::string_view* tokens, std::size_t count, TokenKind* kinds, std::uint32_t* splits) noexcept
+{
+	std::size_t idx = 0;
+
+	// Only the long options are scanned for '=', right after their block while the tokens are in the cache
+	const auto split = [&](std::size_t end) {
+		for (; idx < end; ++idx) {
+			splits[idx] = noSplit;
+
+			if (kinds[idx] == TokenKind::longOption) {
+				splits[idx] = findSplit(tokens[idx]);
+				if (splits[idx] != noSplit)
+					kinds[idx] = TokenKind::longOptionValue;
+			}
+		}
+	};
+
+#if defined(ARGSMANAGER_CLASSIFY_AVX2) || defined(ARGSMANAGER_CLASSIFY_SSE2)
+	while (idx + blockSize <= count) {
+		classifyBlock(tokens + idx, kinds + idx);
+		split(idx + blockSize);
+	}
+#endif
+
+	for (std::size_t tail = idx; tail < count; ++tail)
+		kinds[tail] = scalarKind(tokens[tail]);
+	split(count);
+}
+
+const char* TokenClassifier::instructionSet() noexcept
+{
+#if defined(ARGSMANAGER_CLASSIFY_AVX2)
+	return "avx2";
+#elif defined(ARGSMANAGER_CLASSIFY_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+	@brief Shape of a token of the command line, decided by its first characters.
+*/
+enum class TokenKind : std::uint8_t {
+	value = 0,       ///< does not start with '-': the content of an argument or a name without dashes.
+	empty,           ///< empty token.
+	shortOption,     ///< -x, also a single "-".
+	longOption,      ///< --name.
+	longOptionValue, ///< --name=value, the split is the position of '='.
+	terminator,      ///< "--".
+	negativeNumber   ///< '-' followed by a digit or '.', for example: -5 or -.5.
+};
+
+/**
+	@brief
+	Classifies the tokens before they are matched. The tokens are classified in blocks:
+	their first characters are gathered and compared all at once with SSE2 (16 tokens) or AVX2 (32 tokens),
+	and the long options are scanned for '=' 16 or 32 characters at a time.
+	The instruction set is selected at compile time: AVX2 if the compiler targets it, SSE2 on x86-64,
+	otherwise, or with ARGSMANAGER_NO_SIMD, the scalar code which gives the same results.
+*/
+class TokenClassifier
+{
+
+public:
+
+	static constexpr std::uint32_t noSplit = ~std::uint32_t(0);
+
+	/**
+		@brief Classifies one token.
+		@return Kind of the token.
+		@param token token of the command line.
+		@param split receives the position of '=' for TokenKind::longOptionValue, otherwise noSplit.
+	*/
+	static TokenKind classify(std::string_view token, std::uint32_t& split) noexcept;
+
+	/**
+		@brief Classifies the tokens in bulk.
+		@param tokens tokens of the command line.
+		@param count count of the tokens.
+		@param kinds receives the kinds of the tokens, count elements.
+		@param splits receives the positions of '=' (see classify()), count elements.
+	*/
+	static void classify(const std::string_view* tokens, std::size_t count, TokenKind* kinds, std::uint32_t* splits) noexcept;
+
+	/**
+		@brief Returns the name of the instruction set used by classify(): "avx2", "sse2" or "scalar".
+	*/
+	static const char* instructionSet() noexcept;
+};
@@ -0,0 +1,90 @@
+#include "ArgsManager.h"
+
+namespace {
+
+	bool isSpace(char symbol)
+	{
+		return symbol == ' ' || symbol == '\t' || symbol == '\n' || symbol == '\r' || symbol == '\v' || symbol == '\f';
+	}
+
+	// Characters escaped by a backslash inside of double quotes
+	bool isQuotedEscape(char symbol)
+	{
+		return symbol == '"' || symbol == '\\' || symbol == '$' || symbol == '`';
+	}
+
+}
+
+Tokenizer::Tokenizer(char* data, std::size_t size) noexcept :
+	data(data), size((data != nullptr) ? size : 0) {}
+
+bool Tokenizer::next(std::string_view& token) noexcept
+{
+	while (readPos < size && isSpace(data[readPos]))
+		++readPos;
+
+	if (readPos >= size || unterminated)
+		return false;
+
+	// The token is written over itself, the write position never passes the read position
+	char* const begin = data + readPos;
+	char* out = begin;
+
+	enum class State { plain, singleQuote, doubleQuote } state = State::plain;
+
+	while (readPos < size) {
+		const char symbol = data[readPos];
+
+		if (state == State::plain) {
+			if (isSpace(symbol))
+				break;
+
+			++readPos;
+
+			if (symbol == '\'')
+				state = State::singleQuote;
+			else if (symbol == '"')
+				state = State::doubleQuote;
+			else if (symbol == '\\' && readPos < size)
+				*out++ = data[readPos++];
+			else
+				*out++ = symbol;
+		}
+		else if (state == State::singleQuote) {
+			++readPos;
+
+			if (symbol == '\'')
+				state = State::plain;
+			else
+				*out++ = symbol;
+		}
+		else {
+			++readPos;
+
+			if (symbol == '"')
+				state = State::plain;
+			else if (symbol == '\\' && readPos < size && isQuotedEscape(data[readPos]))
+				*out++ = data[readPos++];
+			else
+				*out++ = symbol;
+		}
+	}
+
+	if (state != State::plain) {
+		unterminated = true;
+		return false;
+	}
+
+	token = std::string_view(begin, static_cast<std::size_t>(out - begin));
+	return true;
+}
+
+bool Tokenizer::unterminatedQuote() const noexcept
+{
+	return unterminated;
+}
+
+std::size_t Tokenizer::position() const noexcept
+{
+	return readPos;
+}
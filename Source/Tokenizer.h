@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+/**
+	@brief
+	Splits a command line into tokens in place, following the shell rules:
+	tokens are separated by whitespace, 'single quotes' keep the text literally,
+	"double quotes" allow the escapes \" \\ \$ \`, a backslash outside of quotes escapes any character.
+	Quotes and escapes are removed by moving the characters of the token to the left inside the buffer,
+	so the tokens are views into the buffer and no memory is allocated.
+*/
+class Tokenizer
+{
+
+private:
+
+	char* data;
+	std::size_t size;
+	std::size_t readPos = 0;
+	bool unterminated = false;
+
+public:
+
+	/**
+		@brief constructor.
+		@param data command line, modified while tokenizing.
+		@param size size of the command line.
+	*/
+	Tokenizer(char* data, std::size_t size) noexcept;
+
+	/**
+		@brief Extracts the next token.
+		@return TRUE if a token was extracted, FALSE at the end of the command line or on an unterminated quote.
+		@param token receives the view of the token into the buffer.
+	*/
+	bool next(std::string_view& token) noexcept;
+
+	/**
+		@brief Returns TRUE if the command line ends inside of quotes, otherwise FALSE.
+	*/
+	bool unterminatedQuote() const noexcept;
+
+	/**
+		@brief Returns the position of the first character not yet tokenized.
+	*/
+	std::size_t position() const noexcept;
+};
@@ -0,0 +1,143 @@
+#include "ArgsManager.h"
+
+#include <charconv>
+#include <limits>
+
+namespace {
+
+	char lower(char symbol)
+	{
+		return (symbol >= 'A' && symbol <= 'Z') ? static_cast<char>(symbol - 'A' + 'a') : symbol;
+	}
+
+	bool equalsNoCase(std::string_view text, std::string_view expected)
+	{
+		if (text.size() != expected.size())
+			return false;
+
+		for (std::size_t idx = 0; idx < text.size(); ++idx) {
+			if (lower(text[idx]) != expected[idx])
+				return false;
+		}
+		return true;
+	}
+
+	// Parses the leading integer, text receives the rest
+	bool parseInteger(std::string_view& text, std::int64_t& value)
+	{
+		// std::from_chars does not accept the plus sign
+		if (!text.empty() && text[0] == '+' && (text.size() == 1 || text[1] != '-'))
+			text.remove_prefix(1);
+
+		const auto converted = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (converted.ec != std::errc())
+			return false;
+
+		text.remove_prefix(static_cast<std::size_t>(converted.ptr - text.data()));
+		return true;
+	}
+
+	bool multiply(std::int64_t& value, std::int64_t factor)
+	{
+		if (value > std::numeric_limits<std::int64_t>::max() / factor ||
+			value < std::numeric_limits<std::int64_t>::min() / factor)
+			return false;
+
+		value *= factor;
+		return true;
+	}
+
+	bool parseByteSize(std::string_view text, std::int64_t& value)
+	{
+		if (!parseInteger(text, value) || value < 0)
+			return false;
+
+		if (text.empty())
+			return true;
+
+		int shift = 0;
+		switch (lower(text[0])) {
+		case 'k': shift = 10; break;
+		case 'm': shift = 20; break;
+		case 'g': shift = 30; break;
+		case 't': shift = 40; break;
+		case 'b': return text.size() == 1;
+		default: return false;
+		}
+
+		text.remove_prefix(1);
+		if (!text.empty() && !equalsNoCase(text, "b") && !equalsNoCase(text, "ib"))
+			return false;
+
+		return multiply(value, std::int64_t(1) << shift);
+	}
+
+	bool parseDuration(std::string_view text, std::int64_t& value)
+	{
+		if (!parseInteger(text, value))
+			return false;
+
+		std::int64_t factor = 0;
+		if (text == "ns")
+			factor = 1;
+		else if (text == "us")
+			factor = 1000;
+		else if (text == "ms")
+			factor = 1000 * 1000;
+		else if (text == "s")
+			factor = 1000 * 1000 * 1000;
+		else if (text == "min")
+			factor = std::int64_t(60) * 1000 * 1000 * 1000;
+		else if (text == "h")
+			factor = std::int64_t(3600) * 1000 * 1000 * 1000;
+		else
+			return false;
+
+		return multiply(value, factor);
+	}
+
+	bool parseBoolean(std::string_view text, std::int64_t& value)
+	{
+		if (text == "1" || equalsNoCase(text, "true") || equalsNoCase(text, "yes") || equalsNoCase(text, "on"))
+			value = 1;
+		else if (text == "0" || equalsNoCase(text, "false") || equalsNoCase(text, "no") || equalsNoCase(text, "off"))
+			value = 0;
+		else
+			return false;
+
+		return true;
+	}
+
+}
+
+bool convertValue(ValueType type, const std::vector<std::string>& choices, std::string_view text, TypedValue& value) noexcept
+{
+	switch (type) {
+	case ValueType::string:
+		return true;
+	case ValueType::integer:
+		return parseInteger(text, value.integer) && text.empty();
+	case ValueType::floating: {
+		if (!text.empty() && text[0] == '+' && (text.size() == 1 || text[1] != '-'))
+			text.remove_prefix(1);
+
+		const auto converted = std::from_chars(text.data(), text.data() + text.size(), value.floating);
+		return converted.ec == std::errc() && converted.ptr == text.data() + text.size();
+	}
+	case ValueType::boolean:
+		return parseBoolean(text, value.integer);
+	case ValueType::byteSize:
+		return parseByteSize(text, value.integer);
+	case ValueType::duration:
+		return parseDuration(text, value.integer);
+	case ValueType::choice:
+		for (std::size_t idx = 0; idx < choices.size(); ++idx) {
+			if (choices[idx] == text) {
+				value.integer = static_cast<std::int64_t>(idx);
+				return true;
+			}
+		}
+		return false;
+	}
+	return false;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+	@brief Type of the content of an argument, the content is converted while parsing.
+*/
+enum class ValueType : std::uint8_t {
+	string = 0, ///< content is kept as text (default).
+	integer,    ///< signed decimal integer, for example: -42.
+	floating,   ///< floating point number, for example: 0.5 or 1e-3.
+	boolean,    ///< true / false, yes / no, on / off, 1 / 0.
+	byteSize,   ///< count of bytes with an optional binary suffix K, M, G, T (optionally followed by B or iB), for example: 64M.
+	duration,   ///< integer with the unit ns, us, ms, s, min or h, for example: 250ms.
+	choice      ///< one of the choices of the argument, stored as the index of the choice.
+};
+
+/**
+	@brief Converted content of an argument: floating for ValueType::floating, integer for the other types
+	(nanoseconds for ValueType::duration, the index of the choice for ValueType::choice).
+*/
+struct TypedValue {
+	std::int64_t integer = 0;
+	double floating = 0.0;
+};
+
+/**
+	@brief Converts the text to the type without allocations and without locale, using std::from_chars.
+	@return TRUE if the text is a valid value of the type, otherwise FALSE.
+	@param type type of the value.
+	@param choices allowed values for ValueType::choice.
+	@param text text of the value.
+	@param value receives the converted value.
+*/
+bool convertValue(ValueType type, const std::vector<std::string>& choices, std::string_view text, TypedValue& value) noexcept;
@@ -1,7 +1,15 @@
 #include "CppUnitTest.h"
 #include "../Source/ArgsManager.h"
+#include "../Source/StaticSchema.h"
 #include "Auxiliary.h"
 
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <optional>
+#include <thread>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace Test
@@ -823,6 +831,2007 @@ namespace Test
 			Assert::IsTrue(argsManager.isHelpArg(argc, argv, 0));
 		}
 
+
+		TEST_METHOD(singlePass_mixedArgs) {
+			argsManager.clear();
+
+			const unsigned int argc = 5;
+			const char* argv[] = {
+				"-v", "--copy", "-i", "input.txt", "-q"
+			};
+
+			argsManager
+				.addRequired(Argument(true, "-i", "--input"))
+				.addRequiredToSet(Argument(false, "--move"))
+				.addRequiredToSet(Argument(false, "--copy"))
+				.addOptional(Argument(false, "-v", "--verbose"))
+				.addOptional(Argument(false, "-d"));
+
+			try {
+				argsManager.parse(argc, argv, 0);
+				Assert::IsTrue(argsManager.argValue("--input") == "input.txt");
+				Assert::IsTrue(argsManager.argPresent("--copy"));
+				Assert::IsFalse(argsManager.argPresent("--move"));
+				Assert::IsTrue(argsManager.argPresent("--verbose"));
+				Assert::IsFalse(argsManager.argPresent("-d"));
+			}
+			catch (const std::exception& ex) {
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+		}
+
+		TEST_METHOD(singlePass_contentIsNotArgument) {
+			argsManager.clear();
+
+			const unsigned int argc = 2;
+			const char* argv[] = {
+				"-o", "verbose"
+			};
+
+			argsManager
+				.addRequired(Argument(true, "-o"))
+				.addOptional(Argument(false, "verbose"));
+
+			try {
+				argsManager.parse(argc, argv, 0);
+				Assert::IsTrue(argsManager.argValue("-o") == "verbose");
+				Assert::IsFalse(argsManager.argPresent("verbose"));
+			}
+			catch (const std::exception& ex) {
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+		}
+
+		TEST_METHOD(singlePass_firstOccurrenceWins) {
+			argsManager.clear();
+
+			const unsigned int argc = 4;
+			const char* argv[] = {
+				"-a", "first", "-a", "second"
+			};
+
+			argsManager.addOptional(Argument(true, "-a"));
+
+			try {
+				argsManager.parse(argc, argv, 0);
+				Assert::IsTrue(argsManager.argValue("-a") == "first");
+			}
+			catch (const std::exception& ex) {
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+		}
+
+		TEST_METHOD(checkDiplicationMixedArgsAdd) {
+			argsManager.clear();
+
+			try {
+				argsManager.addRequired(Argument(false, "-a", "--append"));
+				argsManager.addOptional(Argument(true, "-b", "--append"));
+			}
+			catch (...) {
+				return;
+			}
+
+			Assert::Fail(L"Parameter already added but no exception thrown");
+		}
+
+		TEST_METHOD(freeze_planReused) {
+			argsManager.clear();
+
+			argsManager.addRequired(Argument(false, "-a"));
+
+			const auto plan = argsManager.freeze();
+			Assert::IsTrue(plan == argsManager.freeze());
+			Assert::IsTrue(plan->size() == 1);
+			Assert::IsTrue(plan->find("-a") == 0);
+			Assert::IsTrue(plan->find("-b") == ParserPlan::npos);
+
+			argsManager.addOptional(Argument(false, "-b"));
+
+			const auto newPlan = argsManager.freeze();
+			Assert::IsFalse(plan == newPlan);
+			Assert::IsTrue(plan->size() == 1);
+			Assert::IsTrue(newPlan->find("-b") == 1);
+		}
+
+		TEST_METHOD(freeze_manyArgs) {
+			argsManager.clear();
+
+			for (int idx = 0; idx < 100; ++idx)
+				argsManager.addOptional(Argument(false, "--opt" + std::to_string(idx)));
+			argsManager.addRequired(Argument(true, "--last"));
+
+			const unsigned int argc = 3;
+			const char* argv_1[] = {
+				"--opt99", "--last", "value"
+			};
+			const char* argv_2[] = {
+				"--opt99", "--opt1", "--opt2"
+			};
+
+			try {
+				argsManager.parse(argc, argv_1, 0);
+				Assert::IsTrue(argsManager.argPresent("--opt99"));
+				Assert::IsTrue(argsManager.argValue("--last") == "value");
+			}
+			catch (const std::exception& ex) {
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+
+			try {
+				argsManager.parse(argc, argv_2, 0);
+			}
+			catch (const InvalidArg&) {
+				return;
+			}
+
+			Assert::Fail(L"Required argument not set, but no exception was thrown!");
+		}
+
+		TEST_METHOD(contentMode_copy) {
+			argsManager.clear();
+
+			char value[] = "helloWorld";
+			const unsigned int argc = 2;
+			const char* argv[] = {
+				"-a", value
+			};
+
+			argsManager.addRequired(Argument(true, "-a"));
+
+			try {
+				argsManager.parse(argc, argv, 0);
+				value[0] = 'H';
+				Assert::IsTrue(argsManager.argValue("-a") == "helloWorld");
+				Assert::IsFalse(argsManager.argValue("-a").data() == value);
+			}
+			catch (const std::exception& ex) {
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+		}
+
+		TEST_METHOD(contentMode_view) {
+			argsManager.clear();
+			argsManager.setContentMode(ContentMode::view);
+
+			const unsigned int argc = 2;
+			const char* argv[] = {
+				"-a", "helloWorld"
+			};
+
+			argsManager.addRequired(Argument(true, "-a"));
+
+			try {
+				argsManager.parse(argc, argv, 0);
+				argsManager.setContentMode(ContentMode::copy);
+				Assert::IsTrue(argsManager.argValue("-a") == "helloWorld");
+				Assert::IsTrue(argsManager.argValue("-a").data() == argv[1]);
+			}
+			catch (const std::exception& ex) {
+				argsManager.setContentMode(ContentMode::copy);
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+		}
+
+		TEST_METHOD(argId_lookup) {
+			argsManager.clear();
+
+			ArgId inputId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			ArgId quietId = ParserPlan::npos;
+
+			argsManager
+				.addRequired(Argument(true, "-i", "--input"), inputId)
+				.addOptional(Argument(false, "-v"), verboseId)
+				.addOptional(Argument(false, "-q"), quietId);
+
+			Assert::IsTrue(inputId == 0);
+			Assert::IsTrue(verboseId == 1);
+			Assert::IsTrue(quietId == 2);
+			Assert::IsTrue(argsManager.argId("--input") == inputId);
+
+			const unsigned int argc = 3;
+			const char* argv[] = {
+				"--input", "file", "-v"
+			};
+
+			try {
+				argsManager.parse(argc, argv, 0);
+				Assert::IsTrue(argsManager.argValue(inputId) == "file");
+				Assert::IsTrue(argsManager.argPresent(verboseId));
+				Assert::IsFalse(argsManager.argPresent(quietId));
+			}
+			catch (const std::exception& ex) {
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+		}
+
+		TEST_METHOD(argId_invalid) {
+			argsManager.clear();
+
+			ArgId id = ParserPlan::npos;
+			argsManager.addOptional(Argument(true, "-a"), id);
+
+			const unsigned int argc = 1;
+			const char* argv[] = {
+				"-b"
+			};
+
+			argsManager.parse(argc, argv, 0);
+
+			try {
+				argsManager.argPresent(id + 1);
+				Assert::Fail(L"Handle out of range, but no exception was thrown!");
+			}
+			catch (const std::out_of_range&) {
+			}
+
+			try {
+				argsManager.argValue(id);
+			}
+			catch (const InvalidArg&) {
+				return;
+			}
+
+			Assert::Fail(L"Argument not passed, but no exception was thrown!");
+		}
+
+		TEST_METHOD(argOccurrences_counted) {
+			argsManager.clear();
+
+			ArgId verboseId = ParserPlan::npos;
+			ArgId includeId = ParserPlan::npos;
+			ArgId quietId = ParserPlan::npos;
+
+			argsManager
+				.addOptional(Argument(false, "-v"), verboseId)
+				.addOptional(Argument(true, "-I"), includeId)
+				.addOptional(Argument(false, "-q"), quietId);
+
+			const unsigned int argc = 7;
+			const char* argv[] = {
+				"-v", "-I", "first", "-v", "-I", "second", "-v"
+			};
+
+			try {
+				argsManager.parse(argc, argv, 0);
+				Assert::IsTrue(argsManager.argOccurrences(verboseId) == 3);
+				Assert::IsTrue(argsManager.argOccurrences(includeId) == 2);
+				Assert::IsTrue(argsManager.argOccurrences(quietId) == 0);
+				Assert::IsTrue(argsManager.argValue(includeId) == "first");
+			}
+			catch (const std::exception& ex) {
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+		}
+
+		TEST_METHOD(instances_independent) {
+			ArgsManager first;
+			ArgsManager second;
+
+			first.addRequired(Argument(true, "-a"));
+			second.addRequired(Argument(true, "-b"));
+
+			const char* argv_1[] = {
+				"-a", "first"
+			};
+			const char* argv_2[] = {
+				"-b", "second"
+			};
+
+			try {
+				first.parse(2, argv_1, 0);
+				second.parse(2, argv_2, 0);
+				Assert::IsTrue(first.argValue("-a") == "first");
+				Assert::IsTrue(second.argValue("-b") == "second");
+				Assert::IsFalse(first.argPresent("-b"));
+			}
+			catch (const std::exception& ex) {
+				Assert::Fail(toWstring(ex.what()).c_str());
+			}
+		}
+
+		TEST_METHOD(plan_concurrentParse) {
+			ArgsManager manager;
+			manager
+				.addRequired(Argument(true, "-i", "--input"))
+				.addOptional(Argument(false, "-v"));
+
+			const auto plan = manager.freeze();
+
+			bool failed[4] = {};
+			std::thread threads[4];
+
+			for (int threadIdx = 0; threadIdx < 4; ++threadIdx) {
+				threads[threadIdx] = std::thread([&plan, &failed, threadIdx] {
+					const std::string value = "file" + std::to_string(threadIdx);
+					const char* argv[] = {
+						"--input", value.c_str(), "-v"
+					};
+
+					ParseResult result;
+					for (int iteration = 0; iteration < 1000; ++iteration) {
+						plan->parse(3, argv, 0, result);
+						if (result.argValue("-i") != value || !result.argPresent("-v"))
+							failed[threadIdx] = true;
+					}
+				});
+			}
+
+			for (auto& thread : threads)
+				thread.join();
+
+			for (const bool threadFailed : failed)
+				Assert::IsFalse(threadFailed);
+		}
+
+		TEST_METHOD(plan_resultOutlivesManager) {
+			ParseResult result;
+
+			{
+				ArgsManager manager;
+				manager.addRequired(Argument(true, "-a"));
+
+				const char* argv[] = {
+					"-a", "helloWorld"
+				};
+				result = manager.freeze()->parse(2, argv, 0);
+			}
+
+			Assert::IsTrue(result.argValue("-a") == "helloWorld");
+		}
+
+		TEST_METHOD(tryParse_errors) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.addOptional(Argument(false, "-v"));
+
+			const auto plan = manager.freeze();
+			ParseResult result;
+
+			const char* argv_1[] = {
+				"-v", "-i"
+			};
+			ParseError error = plan->tryParse(2, argv_1, 0, result);
+			Assert::IsTrue(error.code == ParseErrc::missingContent);
+			Assert::IsTrue(error.token == 1);
+			Assert::IsTrue(error.arg == inputId);
+
+			const char* argv_2[] = {
+				"-v"
+			};
+			error = plan->tryParse(1, argv_2, 0, result);
+			Assert::IsTrue(error.code == ParseErrc::missingRequired);
+			Assert::IsTrue(plan->errorMessage(error) == "Parameter '-i' not found!");
+
+			const char* argv_3[] = {
+				"-i", "file"
+			};
+			error = plan->tryParse(2, argv_3, 0, result);
+			Assert::IsFalse(static_cast<bool>(error));
+			Assert::IsTrue(result.argValue(inputId) == "file");
+		}
+
+		TEST_METHOD(batchParse) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.addOptional(Argument(false, "-v"), verboseId);
+
+			std::vector<std::string> values;
+			for (int idx = 0; idx < 2000; ++idx)
+				values.push_back("file" + std::to_string(idx));
+
+			std::vector<std::vector<const char*>> lines;
+			for (int idx = 0; idx < 2000; ++idx) {
+				if (idx % 10 == 0)
+					lines.push_back({ "-v" });
+				else if (idx % 2 == 0)
+					lines.push_back({ "-i", values[idx].c_str(), "-v" });
+				else
+					lines.push_back({ "-i", values[idx].c_str() });
+			}
+
+			const BatchResult batch = BatchParser(manager.freeze(), 4).parse(lines);
+
+			Assert::IsTrue(batch.lines() == 2000);
+			Assert::IsTrue(batch.errorCount() == 200);
+
+			for (std::size_t idx = 0; idx < batch.lines(); ++idx) {
+				if (idx % 10 == 0) {
+					Assert::IsTrue(batch.error(idx) == ParseErrc::missingRequired);
+					continue;
+				}
+				Assert::IsTrue(batch.error(idx) == ParseErrc::none);
+				Assert::IsTrue(batch.argValue(idx, inputId) == values[idx]);
+				Assert::IsTrue(batch.argPresent(idx, verboseId) == (idx % 2 == 0));
+			}
+		}
+
+
+		TEST_METHOD(commandLine_quotes) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			ArgId outputId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.addOptional(Argument(true, "-o"), outputId)
+				.addOptional(Argument(false, "-v"), verboseId);
+
+			std::string commandLine = "  -i 'my file.txt'\t-o \"out \\\"dir\\\"\" -v";
+			manager.parseCommandLine(commandLine);
+
+			Assert::IsTrue(manager.argValue(inputId) == "my file.txt");
+			Assert::IsTrue(manager.argValue(outputId) == "out \"dir\"");
+			Assert::IsTrue(manager.argPresent(verboseId));
+		}
+
+		TEST_METHOD(commandLine_escapes) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			manager.addRequired(Argument(true, "-i"), inputId);
+
+			std::string commandLine = "-i a\\ b\\'c";
+			manager.parseCommandLine(commandLine);
+			Assert::IsTrue(manager.argValue(inputId) == "a b'c");
+
+			commandLine = "-i 'a\\b'\"c\\d\"";
+			manager.parseCommandLine(commandLine);
+			Assert::IsTrue(manager.argValue(inputId) == "a\\bc\\d");
+		}
+
+		TEST_METHOD(commandLine_view) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.setContentMode(ContentMode::view);
+
+			std::string commandLine = "-i \"file\"";
+			manager.parseCommandLine(commandLine);
+
+			const Content content = manager.argValue(inputId);
+			Assert::IsTrue(content == "file");
+			Assert::IsTrue(content.data() >= commandLine.data() &&
+				content.data() + content.size() <= commandLine.data() + commandLine.size());
+		}
+
+		TEST_METHOD(commandLine_errors) {
+			ArgsManager manager;
+			manager.addRequired(Argument(true, "-i"));
+
+			std::string commandLine = "-i 'file";
+			try {
+				manager.parseCommandLine(commandLine);
+				Assert::Fail();
+			}
+			catch (InvalidArg& e) {
+				Assert::IsTrue(std::string(e.what()) == "Argument 2 has an unterminated quote.");
+			}
+
+			const auto plan = manager.freeze();
+			ParseResult result;
+
+			commandLine = "-v -i";
+			ParseError error = plan->tryParseCommandLine(commandLine.data(), commandLine.size(), result);
+			Assert::IsTrue(error.code == ParseErrc::missingContent);
+			Assert::IsTrue(error.token == 1);
+
+			error = plan->tryParseCommandLine(nullptr, 1, result);
+			Assert::IsTrue(error.code == ParseErrc::nullArgv);
+		}
+
+
+		TEST_METHOD(responseFile_nested) {
+			const auto directory = std::filesystem::temp_directory_path();
+			const auto outer = directory / "ArgsManagerTest_outer.rsp";
+			const auto inner = directory / "ArgsManagerTest_inner.rsp";
+
+			std::ofstream(outer) << "-i 'my file.txt'\n@ArgsManagerTest_inner.rsp\n";
+			std::ofstream(inner) << "-v\n";
+
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			ArgId outputId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.addOptional(Argument(false, "-v"), verboseId)
+				.addOptional(Argument(true, "-o"), outputId);
+			manager.setResponseFiles(true);
+
+			const std::string responseArg = "@" + outer.string();
+			const char* argv[] = {
+				"program", responseArg.c_str(), "-o", "out"
+			};
+			manager.parse(4, argv, 1);
+
+			Assert::IsTrue(manager.argValue(inputId) == "my file.txt");
+			Assert::IsTrue(manager.argPresent(verboseId));
+			Assert::IsTrue(manager.argValue(outputId) == "out");
+
+			manager.setContentMode(ContentMode::view);
+			manager.parse(4, argv, 1);
+			Assert::IsTrue(manager.argValue(inputId) == "my file.txt");
+
+			std::filesystem::remove(outer);
+			std::filesystem::remove(inner);
+		}
+
+		TEST_METHOD(responseFile_errors) {
+			const auto directory = std::filesystem::temp_directory_path();
+			const auto cycle = directory / "ArgsManagerTest_cycle.rsp";
+			std::ofstream(cycle) << "-v @ArgsManagerTest_cycle.rsp";
+
+			ArgsManager manager;
+			manager.addOptional(Argument(false, "-v"));
+			manager.setResponseFiles(true);
+
+			const auto plan = manager.freeze();
+			ParseResult result;
+
+			const std::string cycleArg = "@" + cycle.string();
+			const char* argv_1[] = {
+				"-v", cycleArg.c_str()
+			};
+			ParseError error = plan->tryParse(2, argv_1, 0, result, ParseOptions(ContentMode::copy, true));
+			Assert::IsTrue(error.code == ParseErrc::responseFileCycle);
+			Assert::IsTrue(error.token == 1);
+
+			const char* argv_2[] = {
+				"@ArgsManagerTest_missing.rsp"
+			};
+			error = plan->tryParse(1, argv_2, 0, result, ParseOptions(ContentMode::copy, true));
+			Assert::IsTrue(error.code == ParseErrc::responseFileNotRead);
+
+			// Without the option the token is passed as it is
+			error = plan->tryParse(1, argv_2, 0, result);
+			Assert::IsFalse(static_cast<bool>(error));
+
+			// All the errors of the file are collected, the file not read is skipped
+			const auto errors = directory / "ArgsManagerTest_errors.rsp";
+			std::ofstream(errors) << "-x @ArgsManagerTest_missing.rsp -y -v";
+			const std::string errorsArg = "@" + errors.string();
+			const char* argv_3[] = {
+				errorsArg.c_str(), "-z"
+			};
+			ParseOptions options(ContentMode::copy, true);
+			options.strict = true;
+			const ParseOutcome outcome = plan->tryParseAll(2, argv_3, 0, result, options);
+			Assert::IsTrue(outcome.errorCount() == 4);
+			Assert::IsTrue(outcome.error(0).code == ParseErrc::unknownArgument && outcome.error(0).token == 0);
+			Assert::IsTrue(outcome.error(1).code == ParseErrc::responseFileNotRead && outcome.error(1).token == 0);
+			Assert::IsTrue(outcome.error(2).code == ParseErrc::unknownArgument && outcome.error(2).token == 0);
+			Assert::IsTrue(outcome.error(3).code == ParseErrc::unknownArgument && outcome.error(3).token == 1);
+			Assert::IsTrue(result.argPresent(Argument(false, "-v")));
+
+			std::filesystem::remove(cycle);
+			std::filesystem::remove(errors);
+		}
+
+
+		TEST_METHOD(values_repeatable) {
+			ArgsManager manager;
+			ArgId includeId = ParserPlan::npos;
+			ArgId inputId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "-I").setRepeatable(), includeId)
+				.addOptional(Argument(true, "-i"), inputId);
+
+			const char* argv[] = {
+				"-I", "a", "-i", "first", "-I", "b", "-i", "second", "-I", "c"
+			};
+			manager.parse(10, argv, 0);
+
+			const ValueRange includes = manager.argValues(includeId);
+			Assert::IsTrue(includes.size() == 3);
+			Assert::IsTrue(includes[0] == "a" && includes[1] == "b" && includes[2] == "c");
+			Assert::IsTrue(manager.argValue(includeId) == "a");
+			Assert::IsTrue(manager.argOccurrences(includeId) == 3);
+
+			// Not repeatable: the first occurrence wins
+			const ValueRange inputs = manager.argValues(inputId);
+			Assert::IsTrue(inputs.size() == 1 && inputs[0] == "first");
+		}
+
+		TEST_METHOD(values_arity) {
+			ArgsManager manager;
+			ArgId pointId = ParserPlan::npos;
+			ArgId filesId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "-p").setArity(2), pointId)
+				.addRequired(Argument(true, "--files").setArity(Argument::variadic), filesId)
+				.addOptional(Argument(false, "-v"), verboseId)
+				.setContentMode(ContentMode::view);
+
+			const char* argv[] = {
+				"--files", "a", "b", "c", "-p", "1", "2", "-v"
+			};
+			manager.parse(8, argv, 0);
+
+			std::vector<std::string> files;
+			for (const Content file : manager.argValues(filesId))
+				files.emplace_back(file);
+			Assert::IsTrue(files == std::vector<std::string>({ "a", "b", "c" }));
+			Assert::IsTrue(manager.argValues(filesId)[0].data() == argv[1]);
+
+			const ValueRange point = manager.argValues(pointId);
+			Assert::IsTrue(point.size() == 2 && point[0] == "1" && point[1] == "2");
+			Assert::IsTrue(manager.argPresent(verboseId));
+
+			const char* argv_missing[] = {
+				"--files", "a", "-p", "1", "-v"
+			};
+			try {
+				manager.parse(5, argv_missing, 0);
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+
+			const char* argv_empty[] = {
+				"--files", "-v"
+			};
+			try {
+				manager.parse(2, argv_empty, 0);
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+		}
+
+
+		TEST_METHOD(typed_values) {
+			ArgsManager manager;
+			ArgId countId = ParserPlan::npos;
+			ArgId ratioId = ParserPlan::npos;
+			ArgId cacheId = ParserPlan::npos;
+			ArgId sizeId = ParserPlan::npos;
+			ArgId timeoutId = ParserPlan::npos;
+			ArgId modeId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "-n").setType(ValueType::integer).setRepeatable(), countId)
+				.addOptional(Argument(true, "-r").setType(ValueType::floating), ratioId)
+				.addOptional(Argument(true, "-c").setType(ValueType::boolean), cacheId)
+				.addOptional(Argument(true, "-s").setType(ValueType::byteSize), sizeId)
+				.addOptional(Argument(true, "-t").setType(ValueType::duration), timeoutId)
+				.addOptional(Argument(true, "-m").setChoices({ "fast", "safe" }), modeId);
+
+			const char* argv[] = {
+				"-n", "+42", "-r", "0.25", "-c", "yes", "-s", "64M", "-t", "250ms", "-m", "safe", "-n", "-7"
+			};
+			manager.parse(14, argv, 0);
+
+			Assert::IsTrue(manager.argInt(countId) == 42);
+			Assert::IsTrue(manager.argInt(countId, 1) == -7);
+			Assert::IsTrue(manager.argFloat(ratioId) == 0.25);
+			Assert::IsTrue(manager.argBool(cacheId));
+			Assert::IsTrue(manager.argBytes(sizeId) == 64u * 1024 * 1024);
+			Assert::IsTrue(manager.argDuration(timeoutId) == std::chrono::milliseconds(250));
+			Assert::IsTrue(manager.argChoice(modeId) == 1);
+			Assert::IsTrue(manager.argValue(sizeId) == "64M");
+
+			try {
+				manager.argFloat(countId);
+				Assert::Fail();
+			}
+			catch (std::runtime_error&) {}
+
+			try {
+				manager.argInt(countId, 2);
+				Assert::Fail();
+			}
+			catch (std::out_of_range&) {}
+		}
+
+		TEST_METHOD(typed_errors) {
+			ArgsManager manager;
+			ArgId countId = ParserPlan::npos;
+			ArgId modeId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "-n").setType(ValueType::integer), countId)
+				.addOptional(Argument(true, "-s").setType(ValueType::byteSize))
+				.addOptional(Argument(true, "-t").setType(ValueType::duration))
+				.addOptional(Argument(true, "-m").setChoices({ "fast", "safe" }), modeId);
+
+			const auto plan = manager.freeze();
+			ParseResult result;
+
+			const char* argv_1[] = {
+				"-m", "fast", "-n", "12x"
+			};
+			ParseError error = plan->tryParse(4, argv_1, 0, result);
+			Assert::IsTrue(error.code == ParseErrc::invalidValue);
+			Assert::IsTrue(error.token == 3);
+			Assert::IsTrue(error.arg == countId);
+
+			const char* argv_2[] = {
+				"-m", "slow"
+			};
+			error = plan->tryParse(2, argv_2, 0, result);
+			Assert::IsTrue(error.code == ParseErrc::invalidValue);
+			Assert::IsTrue(plan->errorMessage(error) == "Argument 2 is not a valid value of '-m'. Expected: 'fast' / 'safe'.");
+
+			const char* argv_3[] = {
+				"-n", "99999999999999999999"
+			};
+			Assert::IsTrue(plan->tryParse(2, argv_3, 0, result).code == ParseErrc::invalidValue);
+
+			const char* argv_4[] = {
+				"-s", "16E"
+			};
+			Assert::IsTrue(plan->tryParse(2, argv_4, 0, result).code == ParseErrc::invalidValue);
+
+			const char* argv_5[] = {
+				"-t", "250"
+			};
+			Assert::IsTrue(plan->tryParse(2, argv_5, 0, result).code == ParseErrc::invalidValue);
+
+			try {
+				manager.parse(2, argv_2, 0);
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+		}
+
+
+		TEST_METHOD(lazy_onDemand) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			ArgId includeId = ParserPlan::npos;
+			ArgId levelId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i", "--input"), inputId)
+				.addOptional(Argument(false, "-v"), verboseId)
+				.addOptional(Argument(true, "-I").setRepeatable(), includeId)
+				.addOptional(Argument(true, "-l").setType(ValueType::integer), levelId)
+				.addOptional(Argument(true, "-n").setType(ValueType::integer))
+				.addOptional(Argument(true, "-o"));
+			manager.setLazy(true);
+
+			const char* argv[] = {
+				"program", "-I", "a", "--input", "file", "-l", "-3", "-I", "b", "-n", "many", "-v"
+			};
+			manager.parse(12, argv, 1);
+
+			Assert::IsTrue(manager.argValue(inputId).data() == argv[4]);
+			Assert::IsTrue(manager.argPresent(Argument("-v")));
+			Assert::IsTrue(manager.argInt(levelId) == -3);
+
+			const ValueRange includes = manager.argValues(includeId);
+			Assert::IsTrue(includes.size() == 2 && includes[0] == "a" && includes[1] == "b");
+			Assert::IsTrue(manager.argOccurrences(includeId) == 2);
+			Assert::IsFalse(manager.getResult().parsed());
+
+			// Invalid values of the optional arguments are reported on access
+			Assert::IsFalse(manager.argPresent(Argument("-o")));
+			try {
+				manager.argPresent(Argument("-n"));
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+
+			const char* argv_missing[] = {
+				"program", "-v"
+			};
+			try {
+				manager.parse(2, argv_missing, 1);
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+
+			// Missing content is reported by the parse, as by the eager parse
+			const char* argv_content[] = {
+				"program", "-i", "file", "-o"
+			};
+			try {
+				manager.parse(4, argv_content, 1);
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+
+			// Without required arguments the tokens are matched on the first access, the errors are reported by every access
+			ArgsManager optional;
+			ArgId outputId = ParserPlan::npos;
+			ArgId quietId = ParserPlan::npos;
+			optional
+				.addOptional(Argument(true, "-o", "--output"), outputId)
+				.addOptional(Argument(false, "-q"), quietId);
+			optional.setLazy(true);
+			optional.parse(2, argv_content + 2, 0);
+			for (int access = 0; access < 2; ++access) {
+				try {
+					optional.argPresent(quietId);
+					Assert::Fail();
+				}
+				catch (InvalidArg&) {}
+			}
+
+			const char* argv_null[] = {
+				"-q", nullptr
+			};
+			optional.parse(2, argv_null, 0);
+			try {
+				optional.argPresent(quietId);
+				Assert::Fail();
+			}
+			catch (std::runtime_error&) {}
+
+			// --name=value is declined by the walk and parsed by the matcher on the first access
+			const char* argv_declined[] = {
+				"--output=file", "-q"
+			};
+			optional.parse(2, argv_declined, 0);
+			Assert::IsTrue(optional.argValue(outputId).data() == argv_declined[0] + 9);
+			Assert::IsTrue(optional.argPresent(quietId));
+			Assert::IsFalse(optional.getResult().parsed());
+
+			manager.setLazy(false);
+			const char* argv_eager[] = {
+				"program", "-i", "file"
+			};
+			manager.parse(3, argv_eager, 1);
+			Assert::IsTrue(manager.argValue(inputId) == "file");
+			Assert::IsFalse(manager.argPresent(verboseId));
+		}
+
+		TEST_METHOD(lazy_contentIsNotArgument) {
+			ArgsManager manager;
+			ArgId modeId = ParserPlan::npos;
+			ArgId helpId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "mode"), modeId)
+				.addOptional(Argument(false, "help"), helpId);
+			manager.setLazy(true);
+
+			const char* argv[] = {
+				"mode", "help"
+			};
+			manager.parse(2, argv, 0);
+
+			Assert::IsFalse(manager.argPresent(helpId));
+			Assert::IsTrue(manager.argValue(modeId) == "help");
+		}
+
+
+		TEST_METHOD(incremental_tokens) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.addOptional(Argument(false, "-v"), verboseId);
+
+			IncrementalParser parser(manager.freeze());
+
+			{
+				std::string token = "-i";
+				Assert::IsFalse(static_cast<bool>(parser.feed(token)));
+				token = "file";
+				Assert::IsFalse(static_cast<bool>(parser.feed(token)));
+				// The content was copied, the token can be reused
+				token = "-v";
+				Assert::IsFalse(static_cast<bool>(parser.feed(token)));
+			}
+
+			Assert::IsFalse(static_cast<bool>(parser.finish()));
+			Assert::IsTrue(parser.getResult().argValue(inputId) == "file");
+			Assert::IsTrue(parser.getResult().argPresent(verboseId));
+			Assert::IsTrue(parser.tokens() == 3);
+
+			try {
+				parser.feed("-v");
+				Assert::Fail();
+			}
+			catch (std::runtime_error&) {}
+
+			parser.reset();
+			parser.feed("-v");
+			const ParseError error = parser.finish();
+			Assert::IsTrue(error.code == ParseErrc::missingRequired);
+			Assert::IsTrue(error.arg == inputId);
+
+			parser.reset();
+			Assert::IsTrue(parser.feed("-i").code == ParseErrc::none);
+			Assert::IsTrue(parser.feed("-v").code == ParseErrc::missingContent);
+			Assert::IsTrue(parser.feed("file").code == ParseErrc::missingContent);
+			Assert::IsTrue(parser.finish().code == ParseErrc::missingContent);
+		}
+
+		TEST_METHOD(incremental_byteChunks) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			ArgId includeId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.addOptional(Argument(true, "-I").setRepeatable(), includeId);
+
+			IncrementalParser parser(manager.freeze());
+
+			const std::string stream("-I\0first\0-i\0long-file-name\0-I\0second", 36);
+			for (std::size_t offset = 0; offset < stream.size(); offset += 5) {
+				const std::string chunk = stream.substr(offset, 5);
+				Assert::IsFalse(static_cast<bool>(parser.feedBytes(chunk.data(), chunk.size())));
+			}
+			Assert::IsFalse(static_cast<bool>(parser.finish()));
+
+			const ParseResult& result = parser.getResult();
+			Assert::IsTrue(result.argValue(inputId) == "long-file-name");
+
+			const ValueRange includes = result.argValues(includeId);
+			Assert::IsTrue(includes.size() == 2 && includes[0] == "first" && includes[1] == "second");
+		}
+
+
+		TEST_METHOD(memoryResource_noHeap) {
+			std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+			try {
+				alignas(std::max_align_t) char buffer[64 * 1024];
+				std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+				ArgsManager manager(&arena);
+				ArgId inputId = ParserPlan::npos;
+				ArgId includeId = ParserPlan::npos;
+				manager
+					.addRequired(Argument(true, "-i"), inputId)
+					.addOptional(Argument(true, "-I").setRepeatable(), includeId);
+
+				const char* argv[] = {
+					"-i", "file", "-I", "a", "-I", "b"
+				};
+				manager.parse(6, argv, 0);
+
+				Assert::IsTrue(manager.argValue(inputId) == "file");
+				Assert::IsTrue(manager.argValues(includeId).size() == 2);
+				Assert::IsTrue(manager.freeze()->getRequiredMask().get_allocator().resource() == &arena);
+				Assert::IsTrue(manager.getResult().getResource() == &arena);
+			}
+			catch (...) {
+				std::pmr::set_default_resource(nullptr);
+				throw;
+			}
+
+			std::pmr::set_default_resource(nullptr);
+		}
+
+		TEST_METHOD(memoryResource_move) {
+			std::pmr::monotonic_buffer_resource arena;
+
+			ArgsManager manager(&arena);
+			ArgId inputId = ParserPlan::npos;
+			manager.addRequired(Argument(true, "-i"), inputId);
+
+			const char* argv[] = {
+				"-i", "file"
+			};
+
+			ParseResult result;
+			result = manager.freeze()->parse(2, argv, 0);
+			Assert::IsTrue(result.argValue(inputId) == "file");
+
+			// The result keeps its resource, the content is copied out of the moved result
+			{
+				ParseResult arenaResult(&arena);
+				manager.freeze()->parse(2, argv, 0, arenaResult, ContentMode::view);
+				result = std::move(arenaResult);
+				Assert::IsFalse(arenaResult.parsed());
+			}
+			Assert::IsTrue(result.getResource() == std::pmr::get_default_resource());
+			Assert::IsTrue(result.argValue(inputId) == "file");
+			Assert::IsTrue(result.argValue(inputId).data() != argv[1]);
+
+			ParseResult sameResult(&arena);
+			ParseResult viewResult(&arena);
+			manager.freeze()->parse(2, argv, 0, viewResult, ContentMode::view);
+			sameResult = std::move(viewResult);
+			Assert::IsTrue(sameResult.argValue(inputId).data() == argv[1]);
+
+			// The manager keeps its resource and builds its plan again
+			ArgsManager other;
+			other = std::move(manager);
+			other.parse(2, argv, 0);
+			Assert::IsTrue(other.freeze()->argument(inputId).getArg1() == "-i");
+			Assert::IsTrue(other.getResult().getResource() == std::pmr::get_default_resource());
+			Assert::IsTrue(other.argValue(inputId) == "file");
+		}
+
+		TEST_METHOD(tryParseAll_collectsErrors) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			ArgId levelId = ParserPlan::npos;
+			ArgId outputId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.addOptional(Argument(true, "-l").setType(ValueType::integer), levelId)
+				.addRequired(Argument(true, "-o"), outputId);
+
+			const char* argv[] = {
+				"-l", "high", "-i"
+			};
+			const ParseOutcome outcome = manager.tryParseAll(3, argv, 0);
+
+			Assert::IsFalse(outcome.hasValue());
+			Assert::IsTrue(outcome.errorCount() == 3);
+			Assert::IsTrue(outcome.error(0).code == ParseErrc::invalidValue && outcome.error(0).token == 1);
+			Assert::IsTrue(outcome.error(1).code == ParseErrc::missingContent && outcome.error(1).token == 2);
+			Assert::IsTrue(outcome.error(2).code == ParseErrc::missingRequired && outcome.error(2).arg == outputId);
+			Assert::IsTrue(outcome.error(3).code == ParseErrc::none);
+			Assert::IsTrue(outcome.message(0).find("-l") != std::string::npos);
+			Assert::IsTrue(outcome.message(3).empty());
+
+			try {
+				outcome.value();
+				Assert::Fail();
+			}
+			catch (const InvalidArg&) {}
+		}
+
+		TEST_METHOD(tryParseAll_value) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			manager.addRequired(Argument(true, "-i"), inputId);
+
+			const char* argv[] = {
+				"-i", "file"
+			};
+			const ParseOutcome outcome = manager.tryParseAll(2, argv, 0);
+
+			Assert::IsTrue(static_cast<bool>(outcome));
+			Assert::IsTrue(outcome.errorCount() == 0);
+			Assert::IsTrue(outcome.value().argValue(inputId) == "file");
+
+			const ParseOutcome fatal = manager.tryParseAll(2, nullptr, 0);
+			Assert::IsTrue(fatal.errorCount() == 1 && fatal.error().code == ParseErrc::nullArgv);
+		}
+
+		TEST_METHOD(parseStats_counters) {
+			ArgsManager manager;
+			ArgId inputId = ParserPlan::npos;
+			ArgId levelId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "-i"), inputId)
+				.addOptional(Argument(true, "-l").setType(ValueType::integer), levelId);
+
+			const char* argv[] = {
+				"-i", "file", "-l", "high", "-x"
+			};
+			manager.tryParseAll(5, argv, 0);
+			manager.tryParseAll(2, argv, 0);
+
+			const ParseStats& stats = manager.getStats();
+			const ParseStats cumulative = manager.getCumulativeStats();
+
+			if (!ParseStats::enabled) {
+				Assert::IsTrue(stats.tokens == 0 && cumulative.parses == 0);
+				return;
+			}
+
+			Assert::IsTrue(stats.parses == 1 && stats.tokens == 2 && stats.lookups == 1);
+			Assert::IsTrue(stats.bytesCopied == 4);
+			Assert::IsTrue(stats.errorCount(ParseErrc::invalidValue) == 0);
+
+			Assert::IsTrue(cumulative.parses == 2 && cumulative.tokens == 7);
+			Assert::IsTrue(cumulative.lookups == 4 && cumulative.nameComparisons >= 3);
+			Assert::IsTrue(cumulative.errorCount(ParseErrc::invalidValue) == 1);
+
+			manager.freeze()->clearStats();
+			Assert::IsTrue(manager.getCumulativeStats().parses == 0);
+		}
+
+		TEST_METHOD(tokenClassifier_kinds) {
+			const std::string longName = "--" + std::string(40, 'n') + "=value";
+			const std::string_view samples[] = {
+				"file", "", "-x", "-", "--name", "--name=value", "--", "-5", "-.5", "-x=1", "--=value", longName, "@args"
+			};
+			const TokenKind expected[] = {
+				TokenKind::value, TokenKind::empty, TokenKind::shortOption, TokenKind::shortOption, TokenKind::longOption,
+				TokenKind::longOptionValue, TokenKind::terminator, TokenKind::negativeNumber, TokenKind::negativeNumber,
+				TokenKind::shortOption, TokenKind::longOption, TokenKind::longOptionValue, TokenKind::value
+			};
+			constexpr std::size_t sampleCount = sizeof(samples) / sizeof(samples[0]);
+
+			// Enough tokens for several SIMD blocks and a scalar tail
+			std::vector<std::string_view> tokens;
+			for (std::size_t idx = 0; idx < 100; ++idx)
+				tokens.push_back(samples[idx % sampleCount]);
+
+			std::vector<TokenKind> kinds(tokens.size());
+			std::vector<std::uint32_t> splits(tokens.size());
+			TokenClassifier::classify(tokens.data(), tokens.size(), kinds.data(), splits.data());
+
+			for (std::size_t idx = 0; idx < tokens.size(); ++idx) {
+				std::uint32_t split = 0;
+				Assert::IsTrue(kinds[idx] == expected[idx % sampleCount]);
+				Assert::IsTrue(TokenClassifier::classify(tokens[idx], split) == kinds[idx] && split == splits[idx]);
+			}
+
+			Assert::IsTrue(splits[5] == 6);
+			Assert::IsTrue(splits[11] == 42);
+			Assert::IsTrue(splits[0] == TokenClassifier::noSplit && splits[10] == TokenClassifier::noSplit);
+
+			// '=' at every position of the scanned blocks, with and without a value after it
+			for (std::size_t pos = 3; pos < 70; ++pos) {
+				const std::string token = "--" + std::string(pos - 2, 'n') + "=";
+				std::uint32_t split = 0;
+
+				Assert::IsTrue(TokenClassifier::classify(token, split) == TokenKind::longOptionValue && split == pos);
+				Assert::IsTrue(TokenClassifier::classify(token + "value", split) == TokenKind::longOptionValue && split == pos);
+				Assert::IsTrue(TokenClassifier::classify(token.substr(0, pos), split) == TokenKind::longOption);
+			}
+		}
+
+		TEST_METHOD(tokenClassifier_longCommandLine) {
+			ArgsManager manager;
+			ArgId levelId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "-l").setType(ValueType::integer).setRepeatable(), levelId)
+				.addOptional(Argument(false, "--verbose"), verboseId);
+
+			// More tokens than one batch of the classifier
+			std::vector<std::string> storage;
+			for (int idx = 0; idx < 150; ++idx) {
+				storage.push_back("-l");
+				storage.push_back(std::to_string(-idx));
+			}
+			storage.push_back("--verbose");
+
+			std::vector<const char*> argv;
+			for (const auto& token : storage)
+				argv.push_back(token.c_str());
+
+			manager.parse(static_cast<unsigned int>(argv.size()), argv.data(), 0);
+
+			Assert::IsTrue(manager.argPresent(verboseId));
+			Assert::IsTrue(manager.argValues(levelId).size() == 150);
+			Assert::IsTrue(manager.argInt(levelId, 149) == -149);
+		}
+
+		TEST_METHOD(joined_tokens) {
+			ArgsManager manager;
+			ArgId outputId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			ArgId extractId = ParserPlan::npos;
+			ArgId fileId = ParserPlan::npos;
+			ArgId levelId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "--output", "-o"), outputId)
+				.addOptional(Argument(false, "-v").setRepeatable(true), verboseId)
+				.addOptional(Argument(false, "-x"), extractId)
+				.addOptional(Argument(true, "-f"), fileId)
+				.addOptional(Argument(true, "--level").setType(ValueType::integer), levelId);
+
+			// The content is viewed in the tokens
+			manager.setContentMode(ContentMode::view);
+
+			const char* argv_1[] = {
+				"--output=result=1.txt", "-vvv", "-xvf", "archive.tar", "--level=-5"
+			};
+			manager.parse(5, argv_1, 0);
+			Assert::IsTrue(manager.argValue(outputId) == "result=1.txt");
+			Assert::IsTrue(manager.argValue(outputId).data() == argv_1[0] + 9);
+			Assert::IsTrue(manager.argOccurrences(verboseId) == 4);
+			Assert::IsTrue(manager.argPresent(extractId));
+			Assert::IsTrue(manager.argValue(fileId) == "archive.tar");
+			Assert::IsTrue(manager.argInt(levelId) == -5);
+
+			// Attached content of a short name, alone or at the end of a bundle
+			const char* argv_2[] = {
+				"-ofile", "-xvfarchive.tar", "--output="
+			};
+			manager.parse(3, argv_2, 0);
+			Assert::IsTrue(manager.argValue(outputId) == "file");
+			Assert::IsTrue(manager.argOccurrences(outputId) == 2);
+			Assert::IsTrue(manager.argValue(fileId) == "archive.tar");
+			Assert::IsTrue(manager.argOccurrences(verboseId) == 1);
+
+			// A bundle with an unknown name is ignored as a whole
+			const char* argv_3[] = {
+				"-xvq", "--unknown=value"
+			};
+			manager.parse(2, argv_3, 0);
+			Assert::IsFalse(manager.argPresent(extractId));
+			Assert::IsFalse(manager.argPresent(verboseId));
+
+			const auto plan = manager.freeze();
+			ParseResult result;
+
+			const char* argv_4[] = {
+				"-v", "-x=yes"
+			};
+			Assert::IsTrue(plan->tryParse(2, argv_4, 0, result).code == ParseErrc::none);
+
+			const char* argv_5[] = {
+				"--output", "--level=x"
+			};
+			ParseError error = plan->tryParse(2, argv_5, 0, result);
+			Assert::IsTrue(error.code == ParseErrc::missingContent && error.arg == outputId);
+
+			const char* argv_6[] = {
+				"-o", "file", "--level=x"
+			};
+			error = plan->tryParse(3, argv_6, 0, result);
+			Assert::IsTrue(error.code == ParseErrc::invalidValue && error.token == 2 && error.arg == levelId);
+
+			ArgsManager flags;
+			flags.addOptional(Argument(false, "--verbose"));
+			const char* argv_7[] = {
+				"--verbose=yes"
+			};
+			const ParseError flagError = flags.freeze()->tryParse(1, argv_7, 0, result);
+			Assert::IsTrue(flagError.code == ParseErrc::unexpectedValue);
+			Assert::IsTrue(flags.freeze()->errorMessage(flagError) == "Argument 1: '--verbose' does not take a value.");
+
+			try {
+				flags.parse(1, argv_7, 0);
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+
+			// Names containing '=' are matched as a whole first
+			ArgsManager literal;
+			ArgId literalId = ParserPlan::npos;
+			literal.addOptional(Argument(false, "--mode=fast"), literalId);
+			const char* argv_8[] = {
+				"--mode=fast"
+			};
+			literal.parse(1, argv_8, 0);
+			Assert::IsTrue(literal.argPresent(literalId));
+		}
+
+		TEST_METHOD(environment_fallback) {
+			ArgsManager manager;
+			ArgId outputId = ParserPlan::npos;
+			ArgId levelId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			ArgId quietId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "--output").setEnv("APP_OUTPUT"), outputId)
+				.addOptional(Argument(true, "--level").setType(ValueType::integer).setEnv("APP_LEVEL"), levelId)
+				.addOptional(Argument(false, "--verbose").setEnv("APP_VERBOSE"), verboseId)
+				.addOptional(Argument(false, "--quiet").setEnv("APP_QUIET"), quietId);
+
+			const char* environment[] = {
+				"=C:=C:\\", "PATH=/bin", "APP_OUTPUT=env.txt", "APP_LEVEL=-3", "APP_VERBOSE=yes", "APP_QUIET=0", nullptr
+			};
+			manager.setEnvironment(environment);
+
+			const char* argv_1[] = {
+				"--output", "file.txt"
+			};
+			const char* argv_2[] = {
+				"--verbose"
+			};
+			for (const bool lazy : { false, true }) {
+				manager.setLazy(lazy);
+
+				manager.parse(2, argv_1, 0);
+				Assert::IsTrue(manager.argValue(outputId) == "file.txt");
+				Assert::IsTrue(manager.argSource(outputId) == ValueSource::commandLine);
+				Assert::IsTrue(manager.argInt(levelId) == -3);
+				Assert::IsTrue(manager.argSource(levelId) == ValueSource::environment);
+				Assert::IsTrue(manager.argPresent(verboseId));
+				Assert::IsTrue(manager.argSource(verboseId) == ValueSource::environment);
+				Assert::IsFalse(manager.argPresent(quietId));
+				Assert::IsTrue(manager.argSource(quietId) == ValueSource::none);
+
+				// The required argument is satisfied by the environment
+				manager.parse(1, argv_2, 0);
+				Assert::IsTrue(manager.argValue(outputId) == "env.txt");
+				Assert::IsTrue(manager.argOccurrences(outputId) == 1);
+				Assert::IsTrue(manager.argOccurrences(verboseId) == 1);
+				Assert::IsTrue(manager.argSource(verboseId) == ValueSource::commandLine);
+			}
+			manager.setLazy(false);
+
+			const auto plan = manager.freeze();
+			ParseResult result;
+
+			const char* invalid[] = {
+				"APP_LEVEL=high", "APP_OUTPUT=env.txt", nullptr
+			};
+			const ParseError error = plan->tryParse(1, argv_2, 0, result, ParseOptions(ContentMode::copy, false, invalid));
+			Assert::IsTrue(error.code == ParseErrc::invalidEnvironment && error.arg == levelId);
+			Assert::IsTrue(plan->errorMessage(error) == "Environment variable 'APP_LEVEL' is not a valid value of '--level'.");
+
+			const char* empty[] = { nullptr };
+			Assert::IsTrue(plan->tryParse(1, argv_2, 0, result, ParseOptions(ContentMode::copy, false, empty)).code
+				== ParseErrc::missingRequired);
+
+			// A repeated variable is read at its first entry and does not end the scan
+			const char* repeated[] = {
+				"APP_LEVEL=1", "APP_LEVEL=2", "APP_LEVEL=3", "APP_LEVEL=4", "APP_OUTPUT=env.txt", nullptr
+			};
+			Assert::IsTrue(plan->tryParse(1, argv_2, 0, result, ParseOptions(ContentMode::copy, false, repeated)).code
+				== ParseErrc::none);
+			Assert::IsTrue(result.argInt(levelId) == 1);
+			Assert::IsTrue(result.argValue(outputId) == "env.txt");
+
+			ArgsManager duplicated;
+			duplicated
+				.addOptional(Argument(true, "-a").setEnv("APP_VALUE"))
+				.addOptional(Argument(true, "-b").setEnv("APP_VALUE"));
+			try {
+				duplicated.freeze();
+				Assert::Fail();
+			}
+			catch (std::runtime_error&) {}
+		}
+
+		TEST_METHOD(config_files) {
+			const auto directory = std::filesystem::temp_directory_path();
+			const auto system = (directory / "ArgsManagerTest_system.ini").string();
+			const auto user = (directory / "ArgsManagerTest_user.ini").string();
+
+			std::ofstream(system, std::ios::binary) <<
+				"\xEF\xBB\xBF# system defaults\r\n"
+				"output = system.txt\r\n"
+				"level=1\n"
+				"verbose = yes\n"
+				"include = /usr/include\n"
+				"[server]\n"
+				"port = 80\n"
+				"size = 640 480\n";
+			std::ofstream(user) <<
+				"; user settings\n"
+				"level = 7\n"
+				"verbose = off\n"
+				"include = \"/home/user/include dir\"\n"
+				"include = /opt/include\n"
+				"quiet\n"
+				"unknown = value\n";
+
+			ArgsManager manager;
+			ArgId outputId = ParserPlan::npos;
+			ArgId levelId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			ArgId includeId = ParserPlan::npos;
+			ArgId quietId = ParserPlan::npos;
+			ArgId portId = ParserPlan::npos;
+			ArgId sizeId = ParserPlan::npos;
+			manager
+				.addRequired(Argument(true, "--output", "-o"), outputId)
+				.addOptional(Argument(true, "--level").setType(ValueType::integer).setEnv("APP_LEVEL"), levelId)
+				.addOptional(Argument(false, "--verbose"), verboseId)
+				.addOptional(Argument(true, "-I", "--include").setRepeatable(true), includeId)
+				.addOptional(Argument(false, "-q", "--quiet"), quietId)
+				.addOptional(Argument(true, "--server.port").setType(ValueType::integer), portId)
+				.addOptional(Argument(true, "--server.size").setArity(2).setType(ValueType::integer), sizeId);
+
+			const char* environment[] = {
+				"APP_LEVEL=3", nullptr
+			};
+			manager.setEnvironment(environment);
+			manager.addConfigFile(system).addConfigFile(user);
+
+			const char* argv_1[] = {
+				"-q", "-I", "src"
+			};
+			for (const bool lazy : { false, true }) {
+				manager.setLazy(lazy);
+				manager.parse(3, argv_1, 0);
+
+				// The command line overrides the files, the later file overrides the earlier one and the environment
+				Assert::IsTrue(manager.argValue(outputId) == "system.txt");
+				Assert::IsTrue(manager.argSource(outputId) == ValueSource::configFile);
+				Assert::IsTrue(manager.argInt(levelId) == 7);
+				Assert::IsFalse(manager.argPresent(verboseId));
+				Assert::IsTrue(manager.argValues(includeId).size() == 1 && manager.argValue(includeId) == "src");
+				Assert::IsTrue(manager.argSource(includeId) == ValueSource::commandLine);
+				Assert::IsTrue(manager.argSource(quietId) == ValueSource::commandLine);
+				Assert::IsTrue(manager.argInt(portId) == 80);
+				Assert::IsTrue(manager.argInt(sizeId, 0) == 640 && manager.argInt(sizeId, 1) == 480);
+			}
+			manager.setLazy(false);
+
+			const char* argv_2[] = {
+				"--output", "cli.txt"
+			};
+			manager.setContentMode(ContentMode::view);
+			manager.parse(2, argv_2, 0);
+			Assert::IsTrue(manager.argValue(outputId) == "cli.txt");
+			Assert::IsTrue(manager.argPresent(quietId) && manager.argSource(quietId) == ValueSource::configFile);
+
+			const ValueRange includes = manager.argValues(includeId);
+			Assert::IsTrue(includes.size() == 2);
+			Assert::IsTrue(includes[0] == "/home/user/include dir" && includes[1] == "/opt/include");
+			Assert::IsTrue(manager.argOccurrences(includeId) == 2);
+
+			// The files move with the manager, the moved-from manager no longer views them
+			for (const bool assign : { false, true }) {
+				ArgsManager source;
+				ArgId movedQuietId = ParserPlan::npos;
+				source.addOptional(Argument(false, "-q", "--quiet"), movedQuietId).addConfigFile(user);
+				{
+					std::optional<ArgsManager> moved;
+					if (assign)
+						moved.emplace() = std::move(source);
+					else
+						moved.emplace(std::move(source));
+					moved->parse(0, argv_2, 0);
+					Assert::IsTrue(moved->argSource(movedQuietId) == ValueSource::configFile);
+				}
+				source.addOptional(Argument(false, "-q", "--quiet"), movedQuietId);
+				source.parse(0, argv_2, 0);
+				Assert::IsFalse(source.argPresent(movedQuietId));
+			}
+
+			// Without the files the environment is read
+			manager.clearConfigFiles();
+			manager.parse(2, argv_2, 0);
+			Assert::IsTrue(manager.argInt(levelId) == 3);
+			Assert::IsTrue(manager.argSource(levelId) == ValueSource::environment);
+
+			std::ofstream(user) << "level = high\n";
+			ConfigFile invalid;
+			Assert::IsTrue(invalid.open(user.c_str()));
+			ParseOptions options;
+			options.configFiles = &invalid;
+			options.configCount = 1;
+
+			ParseResult result;
+			const ParseError error = manager.freeze()->tryParse(2, argv_2, 0, result, options);
+			Assert::IsTrue(error.code == ParseErrc::invalidConfigValue && error.token == 0 && error.arg == levelId);
+			Assert::IsTrue(error.configFile == 0);
+			Assert::IsTrue(manager.freeze()->errorMessage(error) == "Line 1 of a configuration file is not a valid value of '--level'.");
+			Assert::IsTrue(manager.freeze()->errorMessage(error, options) == "Line 1 of '" + user + "' is not a valid value of '--level'.");
+
+			// The exception names the failing file among the files of the manager
+			manager.addConfigFile(system).addConfigFile(user);
+			for (const bool lazy : { false, true }) {
+				manager.setLazy(lazy);
+				try {
+					manager.parse(2, argv_2, 0);
+					if (lazy)
+						manager.argInt(levelId);
+					Assert::Fail();
+				}
+				catch (const InvalidArg& e) {
+					Assert::IsTrue(std::string(e.what()) == "Line 1 of '" + user + "' is not a valid value of '--level'.");
+				}
+			}
+			manager.setLazy(false);
+			manager.clearConfigFiles();
+
+			try {
+				manager.addConfigFile((directory / "ArgsManagerTest_missing.ini").string());
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+
+			std::filesystem::remove(system);
+			std::filesystem::remove(user);
+		}
+
+		TEST_METHOD(subcommands) {
+			int definitions = 0;
+			Command root([&](ArgsManager& manager) {
+				++definitions;
+				manager.addOptional(Argument(false, "--version"));
+			});
+
+			root.add("commit", [&](ArgsManager& manager) {
+				++definitions;
+				manager
+					.addRequired(Argument(true, "-m", "--message"))
+					.addOptional(Argument(false, "-a", "--all"));
+			});
+
+			Command& remote = root.add("remote", [&](ArgsManager& manager) {
+				++definitions;
+				manager.addOptional(Argument(false, "-v"));
+			});
+			remote.add("add", [&](ArgsManager& manager) {
+				++definitions;
+				manager.addOptional(Argument(true, "-t"));
+			});
+
+			for (int idx = 0; idx < 60; ++idx)
+				root.add("command" + std::to_string(idx), [&](ArgsManager&) { ++definitions; });
+
+			Assert::IsTrue(definitions == 0);
+
+			ParseResult result;
+			const char* argv_1[] = {
+				"app", "commit", "-a", "-m", "message"
+			};
+			const Command& commit = root.parse(5, argv_1, 1, result);
+			Assert::IsTrue(&commit == root.find("commit"));
+			Assert::IsTrue(commit.path() == "commit");
+			Assert::IsTrue(result.argValue(Argument(true, "-m")) == "message");
+			Assert::IsTrue(result.argPresent(Argument(false, "--all")));
+
+			// Only the selected command is defined
+			Assert::IsTrue(definitions == 1);
+			Assert::IsTrue(commit.built() && !root.built() && !remote.built());
+
+			const char* argv_2[] = {
+				"app", "remote", "add", "-t", "main", "origin"
+			};
+			unsigned int beginIdx = 1;
+			const Command& add = root.dispatch(6, argv_2, beginIdx);
+			Assert::IsTrue(add.path() == "remote add" && beginIdx == 3);
+			Assert::IsTrue(add.getParent() == &remote);
+			Assert::IsTrue(definitions == 1);
+
+			root.parse(6, argv_2, 1, result);
+			Assert::IsTrue(result.argValue(Argument(true, "-t")) == "main");
+			Assert::IsTrue(definitions == 2 && !remote.built());
+
+			// A token which is not a subcommand is parsed by the command reached so far
+			const char* argv_3[] = {
+				"app", "remote", "-v", "add"
+			};
+			Assert::IsTrue(&root.parse(4, argv_3, 1, result) == &remote);
+			Assert::IsTrue(result.argPresent(Argument(false, "-v")));
+
+			const char* argv_4[] = {
+				"app", "--version"
+			};
+			Assert::IsTrue(&root.parse(2, argv_4, 1, result) == &root);
+			Assert::IsTrue(result.argPresent(Argument(false, "--version")));
+			Assert::IsTrue(definitions == 4);
+
+			const char* argv_5[] = {
+				"app", "commit"
+			};
+			try {
+				root.parse(2, argv_5, 1, result);
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+			Assert::IsTrue(definitions == 4);
+
+			try {
+				root.add("commit");
+				Assert::Fail();
+			}
+			catch (std::runtime_error&) {}
+
+			// The plan is built once by concurrent dispatches
+			std::vector<std::thread> threads;
+			std::vector<std::shared_ptr<const ParserPlan>> plans(4);
+			for (std::size_t idx = 0; idx < plans.size(); ++idx)
+				threads.emplace_back([&, idx]() { plans[idx] = root.find("command7")->plan(); });
+			for (auto& thread : threads)
+				thread.join();
+
+			Assert::IsTrue(definitions == 5);
+			for (const auto& plan : plans)
+				Assert::IsTrue(plan == plans[0]);
+		}
+
+		TEST_METHOD(strict_unknown) {
+			ArgsManager manager;
+			manager
+				.addOptional(Argument(false, "-v", "--verbose"))
+				.addOptional(Argument(false, "--version"))
+				.addOptional(Argument(true, "-o", "--output"));
+			const std::shared_ptr<const ParserPlan> plan = manager.freeze();
+
+			ParseOptions options;
+			options.strict = true;
+			ParseResult result;
+
+			const char* argv_1[] = {
+				"app", "--ouput", "file"
+			};
+			ParseError error = plan->tryParse(3, argv_1, 1, result, options);
+			Assert::IsTrue(error.code == ParseErrc::unknownArgument && error.token == 1);
+			Assert::IsTrue(error.arg == plan->indexOf(Argument(true, "--output")));
+			Assert::IsTrue(plan->errorMessage(error).find("--output") != std::string::npos);
+
+			// Unknown options are ignored by default
+			Assert::IsTrue(plan->tryParse(3, argv_1, 1, result).code == ParseErrc::none);
+
+			const char* argv_2[] = {
+				"app", "--verb", "--out=file", "-"
+			};
+			Assert::IsTrue(plan->tryParse(4, argv_2, 1, result, options).code == ParseErrc::none);
+			Assert::IsTrue(result.argPresent(Argument(false, "--verbose")));
+			Assert::IsTrue(result.argValue(Argument(true, "-o")) == "file");
+
+			const char* argv_3[] = {
+				"app", "--ver"
+			};
+			error = plan->tryParse(2, argv_3, 1, result, options);
+			Assert::IsTrue(error.code == ParseErrc::ambiguousArgument);
+
+			const char* argv_4[] = {
+				"app", "-x"
+			};
+			Assert::IsTrue(plan->tryParse(2, argv_4, 1, result, options).code == ParseErrc::unknownArgument);
+
+			// A schema without arguments rejects every option
+			ArgsManager empty;
+			const char* argv_5[] = {
+				"app", "file", "-x"
+			};
+			error = empty.freeze()->tryParse(3, argv_5, 1, result, options);
+			Assert::IsTrue(error.code == ParseErrc::unknownArgument && error.token == 2);
+			Assert::IsTrue(empty.freeze()->tryParseAll(3, argv_5, 1, result, options).errorCount() == 1);
+			Assert::IsTrue(empty.freeze()->tryParse(3, argv_5, 1, result).code == ParseErrc::none);
+
+			manager.setStrict(true);
+			try {
+				manager.parse(2, argv_3, 1);
+				Assert::Fail();
+			}
+			catch (InvalidArg&) {}
+
+			// The error keeps the three nearest names
+			ArgsManager levels;
+			levels
+				.addOptional(Argument(false, "--level1"))
+				.addOptional(Argument(false, "--level2"))
+				.addOptional(Argument(false, "--level3"))
+				.addOptional(Argument(false, "--level4"));
+			const std::shared_ptr<const ParserPlan> levelsPlan = levels.freeze();
+			const char* argv_6[] = {
+				"--levelx"
+			};
+			error = levelsPlan->tryParse(1, argv_6, 0, result, options);
+			Assert::IsTrue(error.code == ParseErrc::unknownArgument && error.arg == 0);
+			Assert::IsTrue(error.alternatives[0] == 1 && error.alternatives[1] == 2);
+			Assert::IsTrue(levelsPlan->errorMessage(error) ==
+				"Argument 1 is unknown. Did you mean '--level1', '--level2' or '--level3'?");
+			error.alternatives[1] = ParserPlan::npos;
+			Assert::IsTrue(levelsPlan->errorMessage(error) ==
+				"Argument 1 is unknown. Did you mean '--level1' or '--level2'?");
+
+			// Suggestions among many names
+			ArgsManager large;
+			for (int idx = 0; idx < 1000; ++idx)
+				large.addOptional(Argument(false, "--option" + std::to_string(idx)));
+			large.addOptional(Argument(false, "--recursive"));
+			const std::shared_ptr<const ParserPlan> largePlan = large.freeze();
+
+			const std::vector<ArgId> nearest = largePlan->suggest("--recrusive");
+			Assert::IsTrue(!nearest.empty() && nearest.front() == largePlan->indexOf(Argument(false, "--recursive")));
+			Assert::IsTrue(largePlan->suggest("--something-else").empty());
+		}
+
+#ifdef __cpp_consteval
+		TEST_METHOD(static_schema) {
+			static constexpr StaticSchema schema{
+				StaticArgument(true, "-i", "--input").required(),
+				StaticArgument(true, "-o", "--output"),
+				StaticArgument(false, "--move")
+			};
+
+			static_assert(schema.size() == 3);
+			static_assert(schema.find("--output") == 1 && schema.find("-i") == 0);
+			static_assert(schema.find("--copy") == ParserPlan::npos);
+			static_assert(schema.argument(2) == "--move");
+
+			StaticResult<schema.size()> result;
+			const char* argv_1[] = {
+				"app", "--input", "a.txt", "--output=b.txt", "--move", "--move", "--unknown", "-i", "c.txt"
+			};
+			Assert::IsTrue(schema.parse(9, argv_1, 1, result).code == ParseErrc::none);
+			Assert::IsTrue(result.argValue(0) == "a.txt");
+			Assert::IsTrue(result.argOccurrences(0) == 2);
+			Assert::IsTrue(result.argValue(1) == "b.txt");
+			Assert::IsTrue(result.argOccurrences(2) == 2);
+
+			const char* argv_2[] = {
+				"app", "--output", "--move"
+			};
+			ParseError error = schema.parse(3, argv_2, 1, result);
+			Assert::IsTrue(error.code == ParseErrc::missingContent && error.token == 1 && error.arg == 1);
+
+			error = schema.parse(1, argv_2, 1, result);
+			Assert::IsTrue(error.code == ParseErrc::missingRequired && error.arg == 0);
+			Assert::IsFalse(result.argPresent(2));
+
+			const char* argv_3[] = {
+				"app", "-i", "a.txt", "--move=yes"
+			};
+			error = schema.parse(4, argv_3, 1, result);
+			Assert::IsTrue(error.code == ParseErrc::unexpectedValue && error.arg == 2);
+
+			try {
+				result.argValue(3);
+				Assert::Fail();
+			}
+			catch (std::out_of_range&) {}
+
+			// Negative numbers, bundles, attached content and "--" follow the rules of the plan
+			static constexpr StaticSchema numbers{
+				StaticArgument(true, "-n").ofType(ValueType::integer),
+				StaticArgument(false, "-v"),
+				StaticArgument(true, "-o").requiredToSet()
+			};
+			StaticResult<numbers.size()> numbersResult;
+			const char* argv_4[] = {
+				"-n", "-5", "-vofile", "--", "-n"
+			};
+			Assert::IsTrue(numbers.parse(5, argv_4, 0, numbersResult, true).code == ParseErrc::none);
+			Assert::IsTrue(numbersResult.argValue(0) == "-5" && numbersResult.argOccurrences(0) == 1);
+			Assert::IsTrue(numbersResult.argPresent(1) && numbersResult.argValue(2) == "file");
+			Assert::IsTrue(numbers.parse(2, argv_4, 0, numbersResult).code == ParseErrc::missingRequiredFromSet);
+
+			// Without the option the last -n is a repeated occurrence
+			Assert::IsTrue(numbers.parse(5, argv_4, 0, numbersResult).code == ParseErrc::none);
+			Assert::IsTrue(numbersResult.argOccurrences(0) == 2 && numbersResult.argValue(0) == "-5");
+
+			// The messages are formatted by the plan of the same arguments
+			ArgsManager manager;
+			schema.registerTo(manager);
+			Assert::IsTrue(manager.freeze()->errorMessage(error).find("--move") != std::string::npos);
+		}
+#endif
+
+		TEST_METHOD(name_table) {
+			std::vector<std::string> storage;
+			for (int idx = 0; idx < 4000; ++idx)
+				storage.push_back(((idx % 2) ? "-m" : "-f") + std::string("option") + std::to_string(idx));
+
+			std::vector<std::string_view> names(storage.begin(), storage.end());
+			names.push_back("--output");
+
+			std::vector<std::int32_t> seeds;
+			std::vector<std::uint32_t> slotOf;
+			Assert::IsTrue(NameTable::generate(names, seeds, slotOf));
+
+			// Every name has its own slot
+			std::vector<NameTable::Slot> slots(names.size());
+			for (std::size_t idx = 0; idx < names.size(); ++idx) {
+				Assert::IsTrue(slots[slotOf[idx]].name.empty());
+				slots[slotOf[idx]] = { names[idx], static_cast<ArgId>(idx) };
+			}
+
+			NameTable table;
+			table.seeds = seeds.data();
+			table.seedCount = static_cast<std::uint32_t>(seeds.size());
+			table.slots = slots.data();
+			table.slotCount = static_cast<std::uint32_t>(slots.size());
+			table.argumentCount = table.slotCount;
+
+			for (std::size_t idx = 0; idx < names.size(); ++idx)
+				Assert::IsTrue(table.find(names[idx]) == idx);
+			Assert::IsTrue(table.find("-foption4000") == ParserPlan::npos);
+			Assert::IsTrue(table.find("") == ParserPlan::npos);
+
+			ArgsManager manager;
+			for (const std::string& name : storage)
+				manager.addOptional(Argument(false, name));
+			manager.addOptional(Argument(true, "--output"));
+			manager.setNameTable(&table);
+
+			const char* argv_1[] = {
+				"app", "-foption10", "--output", "file", "-moption3999", "--unknown"
+			};
+			manager.parse(6, argv_1, 1);
+			Assert::IsTrue(manager.argPresent(Argument(false, "-foption10")));
+			Assert::IsTrue(manager.argPresent(Argument(false, "-moption3999")));
+			Assert::IsFalse(manager.argPresent(Argument(false, "-foption12")));
+			Assert::IsTrue(manager.argValue(Argument(true, "--output")) == "file");
+
+			// The table must hold the names of the registered arguments
+			manager.addOptional(Argument(false, "--extra"));
+			try {
+				manager.freeze();
+				Assert::Fail();
+			}
+			catch (std::invalid_argument&) {}
+
+			names.push_back("--output");
+			Assert::IsFalse(NameTable::generate(names, seeds, slotOf));
+		}
+
+		TEST_METHOD(strict_bundle) {
+			ArgsManager manager;
+			manager.addOptional(Argument(false, "-a"));
+			const std::shared_ptr<const ParserPlan> plan = manager.freeze();
+
+			ParseOptions options;
+			options.strict = true;
+			ParseResult result;
+
+			// The bundle is dropped as a whole when one of its names is unknown
+			const char* argv_1[] = {
+				"app", "-abc"
+			};
+			const ParseError error = plan->tryParse(2, argv_1, 1, result, options);
+			Assert::IsTrue(error.code == ParseErrc::unknownArgument && error.token == 1);
+			Assert::IsFalse(result.argPresent(Argument(false, "-a")));
+
+			Assert::IsTrue(plan->tryParse(2, argv_1, 1, result).code == ParseErrc::none);
+			Assert::IsFalse(result.argPresent(Argument(false, "-a")));
+
+			const char* argv_2[] = {
+				"app", "-aa"
+			};
+			Assert::IsTrue(plan->tryParse(2, argv_2, 1, result, options).code == ParseErrc::none);
+			Assert::IsTrue(result.argOccurrences(0) == 2);
+		}
+
+		TEST_METHOD(batch_environment) {
+#ifdef _WIN32
+			_putenv_s("ARGSMANAGER_TEST_BATCH", "from-environment");
+#else
+			setenv("ARGSMANAGER_TEST_BATCH", "from-environment", 1);
+#endif
+
+			ArgsManager manager;
+			ArgId outputId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "-o").setEnv("ARGSMANAGER_TEST_BATCH"), outputId)
+				.addOptional(Argument(false, "-v"));
+
+			std::vector<std::vector<const char*>> lines;
+			for (int idx = 0; idx < 1000; ++idx) {
+				if (idx % 2 == 0)
+					lines.push_back({ "-v" });
+				else
+					lines.push_back({ "-o", "file" });
+			}
+
+			// The values of the environment outlive the results of the workers
+			const BatchResult batch = BatchParser(manager.freeze(), 4).parse(lines);
+
+#ifdef _WIN32
+			_putenv_s("ARGSMANAGER_TEST_BATCH", "");
+#else
+			unsetenv("ARGSMANAGER_TEST_BATCH");
+#endif
+
+			Assert::IsTrue(batch.errorCount() == 0);
+			for (std::size_t idx = 0; idx < batch.lines(); ++idx)
+				Assert::IsTrue(batch.argValue(idx, outputId) == ((idx % 2 == 0) ? "from-environment" : "file"));
+		}
+
+		TEST_METHOD(options_terminator) {
+			ArgsManager manager;
+			ArgId outputId = ParserPlan::npos;
+			ArgId verboseId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "-o", "--output"), outputId)
+				.addOptional(Argument(false, "-v"), verboseId);
+			const std::shared_ptr<const ParserPlan> plan = manager.freeze();
+
+			ParseOptions options;
+			options.strict = true;
+			options.responseFiles = true;
+			options.optionsTerminator = true;
+			ParseResult result;
+
+			// The tokens following "--" are operands: not options, not response files, not unknown
+			const char* argv_1[] = {
+				"app", "-v", "--", "-o", "file", "--unknown", "@missing.rsp", "--"
+			};
+			Assert::IsTrue(plan->tryParse(8, argv_1, 1, result, options).code == ParseErrc::none);
+			Assert::IsTrue(result.argPresent(verboseId));
+			Assert::IsFalse(result.argPresent(outputId));
+
+			// "--" is not the content of an argument
+			const char* argv_2[] = {
+				"app", "-o", "--", "file"
+			};
+			const ParseError error = plan->tryParse(4, argv_2, 1, result, options);
+			Assert::IsTrue(error.code == ParseErrc::missingContent && error.arg == outputId);
+
+			IncrementalParser incremental(plan, std::pmr::get_default_resource(), options);
+			incremental.feed("-v");
+			incremental.feed("--");
+			incremental.feed("-o");
+			Assert::IsTrue(incremental.finish().code == ParseErrc::none);
+			Assert::IsTrue(incremental.getResult().argPresent(verboseId));
+			Assert::IsFalse(incremental.getResult().argPresent(outputId));
+
+			// Without the option "--" is matched like the other tokens
+			ArgsManager dashes;
+			ArgId dashesId = ParserPlan::npos;
+			dashes
+				.addOptional(Argument(false, "--"), dashesId)
+				.addOptional(Argument(false, "-v"), verboseId);
+			const char* argv_3[] = {
+				"app", "--", "-v"
+			};
+			dashes.parse(3, argv_3, 1);
+			Assert::IsTrue(dashes.argPresent(dashesId) && dashes.argPresent(verboseId));
+
+			dashes.setOptionsTerminator(true);
+			dashes.parse(3, argv_3, 1);
+			Assert::IsFalse(dashes.argPresent(dashesId) || dashes.argPresent(verboseId));
+		}
+
+		TEST_METHOD(batch_values) {
+			ArgsManager manager;
+			ArgId includeId = ParserPlan::npos;
+			ArgId sizeId = ParserPlan::npos;
+			manager
+				.addOptional(Argument(true, "-I").setRepeatable(), includeId)
+				.addOptional(Argument(true, "--size").setArity(2), sizeId);
+
+			std::vector<std::vector<const char*>> lines;
+			for (int idx = 0; idx < 1000; ++idx) {
+				if (idx % 2 == 0)
+					lines.push_back({ "-I", "a", "--size", "1", "2", "-I", "b" });
+				else
+					lines.push_back({ "-I", "c" });
+			}
+
+			// The workers are reused by the second batch
+			const BatchParser parser(manager.freeze(), 4);
+			for (int run = 0; run < 2; ++run) {
+				const BatchResult batch = parser.parse(lines);
+
+				Assert::IsTrue(batch.errorCount() == 0);
+				for (std::size_t idx = 0; idx < batch.lines(); ++idx) {
+					const ValueRange includes = batch.argValues(idx, includeId);
+					const ValueRange sizes = batch.argValues(idx, sizeId);
+					if (idx % 2 == 0) {
+						Assert::IsTrue(includes.size() == 2 && includes[0] == "a" && includes[1] == "b");
+						Assert::IsTrue(sizes.size() == 2 && sizes[0] == "1" && sizes[1] == "2");
+					}
+					else {
+						Assert::IsTrue(includes.size() == 1 && includes[0] == "c");
+						Assert::IsTrue(sizes.empty() && batch.argValue(idx, sizeId).empty());
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(lazy_sameAsEager) {
+			ArgsManager manager;
+			manager
+				.addOptional(Argument(true, "-i", "--input"))
+				.addOptional(Argument(false, "-v"))
+				.addOptional(Argument(false, "-q"))
+				.addOptional(Argument(true, "-I").setRepeatable())
+				.addOptional(Argument(true, "--offset").setType(ValueType::integer).setArity(2))
+				.addOptional(Argument(true, "--files").setArity(Argument::variadic))
+				.addOptional(Argument(true, "-o"));
+
+			const std::vector<std::vector<const char*>> lines = {
+				{ "-i", "a", "-i", "b", "-I", "c", "-I", "d" },
+				{ "--offset", "-1", "-.5", "-v" },
+				{ "--offset", "2", "-3", "--files", "x", "y", "z", "-q" },
+				{ "--files", "x", "-v", "--", "-q", "-o" },
+				{ "-o", "-v" },
+				{ "--input=file", "-vq" },
+				{ "-oout", "-I", "c" }
+			};
+
+			for (const auto& line : lines) {
+				const unsigned int argc = static_cast<unsigned int>(line.size());
+				std::vector<std::string> eager;
+				std::vector<std::string> lazy;
+
+				for (std::vector<std::string>* answers : { &eager, &lazy }) {
+					manager.setLazy(answers == &lazy);
+
+					// The lazy parse reports the invalid values on access
+					try {
+						manager.parse(argc, line.data(), 0);
+
+						std::vector<std::string> parsed;
+						for (ArgId id = 0; id < 7; ++id) {
+							parsed.push_back(std::to_string(manager.argOccurrences(id)));
+							if (id == 1 || id == 2)
+								continue;
+							for (const Content value : manager.argValues(id))
+								parsed.push_back(std::string(value));
+						}
+						*answers = parsed;
+					}
+					catch (InvalidArg& e) {
+						answers->push_back(e.what());
+					}
+				}
+
+				Assert::IsTrue(eager == lazy);
+			}
+			manager.setLazy(false);
+		}
 	};
 
 }
\ No newline at end of file